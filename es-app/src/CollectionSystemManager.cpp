@@ -421,6 +421,8 @@ void CollectionSystemManager::updateSystemsList()
 	// add auto enabled ones
 	addEnabledCollectionsToDisplayedSystems(&mAutoCollectionSystemsData, &map);
 
+	LOG(LogDebug) << "CollectionSystemManager::updateSystemsList : " << CollectionFileData::getAllocationReport();
+
 	// Add custom collections bundle to the system list, if there are items
 	if (mCustomCollectionsBundle->getRootFolder()->getChildren().size() > 0)
 		SystemData::sSystemVector.push_back(mCustomCollectionsBundle);
@@ -484,6 +486,8 @@ void CollectionSystemManager::updateCollectionSystem(FileData* file, const Colle
 
 	auto view = ViewController::get()->getGameListView(curSys, false);
 
+	bool recount = false;
+
 	if (collectionEntry != nullptr)
 	{
 		// remove from index, so we can re-index metadata after refreshing
@@ -492,6 +496,8 @@ void CollectionSystemManager::updateCollectionSystem(FileData* file, const Colle
 		// found and we are removing
 		if (name == "favorites" && !file->getFavorite())
 		{
+			curSys->removeFromGameCountInfo(collectionEntry);
+
 			if (view != nullptr)
 				view.get()->remove(collectionEntry);
 			else
@@ -503,6 +509,10 @@ void CollectionSystemManager::updateCollectionSystem(FileData* file, const Colle
 		{
 			// re-index with new metadata
 			curSys->addToIndex(collectionEntry);
+
+			// The counted statistics follow the changes already, but not the other filtered fields (genre...)
+			FileFilterIndex* index = curSys->getIndex(false);
+			recount = index != nullptr && index->isFiltered();
 		}
 	}
 	else
@@ -514,10 +524,12 @@ void CollectionSystemManager::updateCollectionSystem(FileData* file, const Colle
 			auto newGame = new CollectionFileData(file, curSys);
 			rootFolder->addChild(newGame);
 			curSys->addToIndex(newGame);
+			curSys->addToGameCountInfo(newGame);
 		}
 	}
 
-	curSys->updateDisplayedGameCount();
+	if (recount)
+		curSys->updateDisplayedGameCount();
 
 	if (name == "recent")
 	{
@@ -543,6 +555,8 @@ void CollectionSystemManager::sortLastPlayed(SystemData* system)
 	std::sort(childs.begin(), childs.end(), sort.comparisonFunction);
 	if (!sort.ascending)
 		std::reverse(childs.begin(), childs.end());
+
+	FolderData::onTreeChanged();
 }
 
 void CollectionSystemManager::trimCollectionCount(FolderData* rootFolder, int limit)
@@ -554,6 +568,8 @@ void CollectionSystemManager::trimCollectionCount(FolderData* rootFolder, int li
 	while ((int)childs.size() > limit)
 	{
 		CollectionFileData* gameToRemove = (CollectionFileData*)childs.back();
+		curSys->removeFromGameCountInfo(gameToRemove);
+
 		if (listView != nullptr)
 			listView.get()->remove(gameToRemove);
 		else
@@ -972,16 +988,86 @@ SystemData* CollectionSystemManager::createNewCollectionEntry(const std::string&
 	return newSys;
 }
 
+static bool isInAutoCollection(const CollectionSystemDecl& sysDecl, FileData* game, bool isArcade)
+{
+	switch (sysDecl.type)
+	{
+	case AUTO_ALL_GAMES:
+		return true;
+	case AUTO_VERTICALARCADE:
+		return game->isVerticalArcadeGame();
+	case AUTO_LIGHTGUN:
+		return game->isLightGunGame();
+	case AUTO_WHEEL:
+		return game->isWheelGame();
+	case AUTO_TRACKBALL:
+		return game->isTrackballGame();
+	case AUTO_SPINNER:
+		return game->isSpinnerGame();
+	case AUTO_RETROACHIEVEMENTS:
+		return game->hasCheevos();
+	case AUTO_LAST_PLAYED:
+		return game->getMetadata(MetaDataId::PlayCount) > "0";
+	case AUTO_NEVER_PLAYED:
+		return !(game->getMetadata(MetaDataId::PlayCount) > "0");
+	case AUTO_FAVORITES:
+		// we may still want to add files we don't want in auto collections in "favorites"
+		return game->getFavorite();
+	case AUTO_ARCADE:
+		return isArcade;
+	case AUTO_AT2PLAYERS: 
+	case AUTO_AT4PLAYERS:
+		{
+			std::string players = game->getMetadata(MetaDataId::Players);
+			if (players.empty())
+				return false;
+
+			auto range = game->parsePlayersRange();
+
+			int val = (sysDecl.type == AUTO_AT2PLAYERS ? 2 : 4);
+			return range.first <= 0 ? (val == range.second) : (range.first <= val && val <= range.second);
+		}
+	default:
+		if (!sysDecl.isCustom && !sysDecl.displayIfEmpty)
+		{
+			if (sysDecl.isGenreCollection())
+				return Genres::genreExists(&game->getMetadata(), ((int)sysDecl.type) - 10000);
+			else if (sysDecl.isArcadeSubSystem())
+				return isArcade && game->getMetadata(MetaDataId::ArcadeSystemName) == sysDecl.themeFolder;
+		}
+
+		return true;
+	}
+}
+
 // populates an Automatic Collection System
 void CollectionSystemManager::populateAutoCollection(CollectionSystemData* sysData)
 {
-	SystemData* newSys = sysData->system;
-	CollectionSystemDecl sysDecl = sysData->decl;
-	FolderData* rootFolder = newSys->getRootFolder();
+	populateAutoCollections({ sysData });
+}
+
+#define AUTO_COLLECTION_CHUNK_SIZE	1024
+
+// populates Automatic Collection Systems in a single pass over the games : all the predicates are evaluated for each game,
+// by chunks of games running in parallel. The collection files are then created in the order of the games.
+void CollectionSystemManager::populateAutoCollections(const std::vector<CollectionSystemData*>& collections)
+{
+	if (collections.size() == 0)
+		return;
 
 	bool hiddenSystemsShowGames = Settings::HiddenSystemsShowGames();
 	auto hiddenSystems = Utils::String::split(Settings::getInstance()->getString("HiddenSystems"), ';');
 
+	struct SourceGame
+	{
+		FileData* game;
+		bool isArcade;
+		const std::vector<std::string>* hiddenExts;
+	};
+
+	std::vector<SourceGame> games;
+	std::vector<std::shared_ptr<std::vector<std::string>>> hiddenExtsBySystem;
+
 	for (auto& system : SystemData::sSystemVector)
 	{
 		// we won't iterate all collections
@@ -996,107 +1082,91 @@ void CollectionSystemManager::populateAutoCollection(CollectionSystemData* sysDa
 
 		bool isArcade = system->hasPlatformId(PlatformIds::ARCADE);
 
-		std::vector<std::string> hiddenExts;
+		auto hiddenExts = std::make_shared<std::vector<std::string>>();
 		for (auto ext : Utils::String::split(Settings::getInstance()->getString(system->getName() + ".HiddenExt"), ';'))
-			hiddenExts.push_back("." + Utils::String::toLower(ext));
+			hiddenExts->push_back("." + Utils::String::toLower(ext));
 
-		std::vector<FileData*> files = system->getRootFolder()->getFilesRecursive(GAME);
-		for (auto& game : files)
+		hiddenExtsBySystem.push_back(hiddenExts);
+
+		for (auto game : system->getRootFolder()->getFilesRecursive(GAME))
 		{
 			if (system->isGroupSystem() && game->getSystem() != system)
 				continue;
 
-			bool include = includeFileInAutoCollections(game);
-			if (!include)
+			games.push_back(SourceGame { game, isArcade, hiddenExts.get() });
+		}
+	}
+
+	// matches[chunk][collection]
+	size_t chunkCount = (games.size() + AUTO_COLLECTION_CHUNK_SIZE - 1) / AUTO_COLLECTION_CHUNK_SIZE;
+	std::vector<std::vector<std::vector<FileData*>>> matches(chunkCount, std::vector<std::vector<FileData*>>(collections.size()));
+
+	auto processChunk = [this, &games, &matches, &collections](size_t chunk)
+	{
+		size_t end = std::min(games.size(), (chunk + 1) * AUTO_COLLECTION_CHUNK_SIZE);
+
+		for (size_t i = chunk * AUTO_COLLECTION_CHUNK_SIZE; i < end; i++)
+		{
+			auto& source = games[i];
+			FileData* game = source.game;
+
+			if (!includeFileInAutoCollections(game))
 				continue;
 
-			if (hiddenExts.size() > 0 && game->getType() == GAME)
+			if (source.hiddenExts->size() > 0 && game->getType() == GAME)
 			{
 				std::string extlow = Utils::String::toLower(Utils::FileSystem::getExtension(game->getFileName()));
-				if (std::find(hiddenExts.cbegin(), hiddenExts.cend(), extlow) != hiddenExts.cend())
+				if (std::find(source.hiddenExts->cbegin(), source.hiddenExts->cend(), extlow) != source.hiddenExts->cend())
 					continue;
 			}
 
-			switch (sysDecl.type)
-			{
-			case AUTO_ALL_GAMES:
-				break;
-			case AUTO_VERTICALARCADE:
-				include = game->isVerticalArcadeGame();
-				break;
-			case AUTO_LIGHTGUN:
-				include = game->isLightGunGame();
-				break;
-			case AUTO_WHEEL:
-				include = game->isWheelGame();
-				break;
-			case AUTO_TRACKBALL:
-				include = game->isTrackballGame();
-				break;
-			case AUTO_SPINNER:
-				include = game->isSpinnerGame();
-				break;
-			case AUTO_RETROACHIEVEMENTS:
-				include = game->hasCheevos();
-				break;
-			case AUTO_LAST_PLAYED:
-				include = game->getMetadata(MetaDataId::PlayCount) > "0";
-				break;
-			case AUTO_NEVER_PLAYED:
-				include = !(game->getMetadata(MetaDataId::PlayCount) > "0");
-				break;
-			case AUTO_FAVORITES:
-				// we may still want to add files we don't want in auto collections in "favorites"
-				include = game->getFavorite();
-				break;
-			case AUTO_ARCADE:
-				include = isArcade;
-				break;
-			case AUTO_AT2PLAYERS: 
-			case AUTO_AT4PLAYERS:
-			{
-				std::string players = game->getMetadata(MetaDataId::Players);
-				if (players.empty())
-					include = false;
-				else
-				{
-					auto range = game->parsePlayersRange();
+			for (size_t c = 0; c < collections.size(); c++)
+				if (isInAutoCollection(collections[c]->decl, game, source.isArcade))
+					matches[chunk][c].push_back(game);
+		}
+	};
 
-					int val = (sysDecl.type == AUTO_AT2PLAYERS ? 2 : 4);
-					include = range.first <= 0 ? (val == range.second) : (range.first <= val && val <= range.second);
-				}
-			}
-			break;
+	if (chunkCount > 1 && Settings::getInstance()->getBool("ThreadedLoading"))
+	{
+		Utils::ThreadPool pool("populateAutoCollections", 1);
 
-			default:
-				if (!sysDecl.isCustom && !sysDecl.displayIfEmpty)
-				{
-					if (sysDecl.isGenreCollection())
-						include = Genres::genreExists(&game->getMetadata(), ((int)sysDecl.type) - 10000);
-					else if (sysDecl.isArcadeSubSystem())
-						include = isArcade && game->getMetadata(MetaDataId::ArcadeSystemName) == sysDecl.themeFolder;
-				}
+		for (size_t chunk = 0; chunk < chunkCount; chunk++)
+			pool.queueWorkItem([processChunk, chunk] { processChunk(chunk); });
 
-				break;
-			}
+		pool.wait();
+	}
+	else
+	{
+		for (size_t chunk = 0; chunk < chunkCount; chunk++)
+			processChunk(chunk);
+	}
 
-			if (include)
+	for (size_t c = 0; c < collections.size(); c++)
+	{
+		CollectionSystemData* sysData = collections[c];
+
+		SystemData* newSys = sysData->system;
+		FolderData* rootFolder = newSys->getRootFolder();
+
+		for (auto& chunk : matches)
+		{
+			for (auto game : chunk[c])
 			{
 				CollectionFileData* newGame = new CollectionFileData(game, newSys);
 				rootFolder->addChild(newGame);
 				newSys->addToIndex(newGame);
 			}
 		}
-	}
 
-	if (sysDecl.type == AUTO_LAST_PLAYED)
-	{
-		sortLastPlayed(newSys);
-		trimCollectionCount(rootFolder, LAST_PLAYED_MAX);
-	}
+		if (sysData->decl.type == AUTO_LAST_PLAYED)
+		{
+			sortLastPlayed(newSys);
+			trimCollectionCount(rootFolder, LAST_PLAYED_MAX);
+		}
 
-	sysData->isPopulated = true;
-	updateCollectionFolderMetadata(newSys);
+		sysData->isPopulated = true;
+		updateCollectionFolderMetadata(newSys);
+	}
 }
 
 // populates a Custom Collection System
@@ -1225,29 +1295,39 @@ void CollectionSystemManager::removeCollectionsFromDisplayedSystems()
 
 void CollectionSystemManager::addEnabledCollectionsToDisplayedSystems(std::map<std::string, CollectionSystemData>* colSystemData, std::unordered_map<std::string, FileData*>* pMap)
 {
-	if (Settings::getInstance()->getBool("ThreadedLoading"))
+	std::vector<CollectionSystemData*> autoCollections;
+	std::vector<CollectionSystemData*> customCollections;
+
+	for (auto it = colSystemData->begin(); it != colSystemData->end(); it++)
+	{
+		if (!it->second.isEnabled || it->second.isPopulated)
+			continue;
+
+		if (it->second.decl.isCustom)
+			customCollections.push_back(&(it->second));
+		else
+			autoCollections.push_back(&(it->second));
+	}
+
+	bool threaded = Settings::getInstance()->getBool("ThreadedLoading") && autoCollections.size() + customCollections.size() > 1;
+	if (threaded)
 	{
-		std::vector<CollectionSystemData*> collectionsToPopulate;
-		for (auto it = colSystemData->begin(); it != colSystemData->end(); it++)
-			if (it->second.isEnabled && !it->second.isPopulated)
-				collectionsToPopulate.push_back(&(it->second));
+		CollectionSystemData* allGames = &mAutoCollectionSystemsData["all"];
+		if (!allGames->isPopulated && std::find(autoCollections.cbegin(), autoCollections.cend(), allGames) == autoCollections.cend())
+			autoCollections.push_back(allGames);
+	}
 
-		if (collectionsToPopulate.size() > 1)
-		{
-			getAllGamesCollection();
+	// Auto collections are populated together, in a single pass over the games
+	populateAutoCollections(autoCollections);
 
-			Utils::ThreadPool pool("addEnabledCollectionsToDisplayedSystems", -(int)(std::min(collectionsToPopulate.size(), (size_t)4)));
+	if (threaded && customCollections.size() > 0)
+	{
+		Utils::ThreadPool pool("addEnabledCollectionsToDisplayedSystems", -(int)(std::min(customCollections.size(), (size_t)4)));
 
-			for (auto collection : collectionsToPopulate)
-			{
-				if (collection->decl.isCustom)
-					pool.queueWorkItem([this, collection, pMap] { populateCustomCollection(collection, pMap); });
-				else
-					pool.queueWorkItem([this, collection, pMap] { populateAutoCollection(collection); });
-			}
+		for (auto collection : customCollections)
+			pool.queueWorkItem([this, collection, pMap] { populateCustomCollection(collection, pMap); });
 
-			pool.wait();
-		}
+		pool.wait();
 	}
 
 	// add auto enabled ones
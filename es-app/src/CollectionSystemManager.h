@@ -94,6 +94,7 @@ public:
 
 	void reloadCollection(const std::string& collectionName, bool repopulateGamelist = true);
     void populateAutoCollection(CollectionSystemData* sysData);
+	void populateAutoCollections(const std::vector<CollectionSystemData*>& collections);
 	bool deleteCustomCollection(CollectionSystemData* data);
 
 	bool isCustomCollection(const std::string& collectionName);
@@ -1,4 +1,5 @@
 #include "FileData.h"
+#include "FileDataPool.h"
 
 #include "utils/FileSystemUtil.h"
 #include "utils/StringUtil.h"
@@ -18,11 +19,14 @@
 #include <assert.h>
 #include "SystemConf.h"
 #include "InputManager.h"
+#include "LaunchCommandTemplate.h"
 #include "scrapers/ThreadedScraper.h"
 #include "Gamelist.h" 
 #include "ApiSystem.h"
 #include <time.h>
 #include <algorithm>
+#include <mutex>
+#include <map>
 #include "LangParser.h"
 #include "resources/ResourceManager.h"
 #include "RetroAchievements.h"
@@ -66,13 +70,20 @@ static std::map<std::string, std::function<BindableProperty(FileData*)>> propert
 FileData* FileData::mRunningGame = nullptr;
 
 FileData::FileData(FileType type, const std::string& path, SystemData* system)
-	: mPath(path), mType(type), mSystem(system), mParent(nullptr), mDisplayName(nullptr), mMetadata(type == GAME ? GAME_METADATA : FOLDER_METADATA) // metadata is REALLY set in the constructor!
+	: mPath(path), mType(type), mSystem(system), mParent(nullptr), mDisplayName(nullptr), mNameCache(nullptr), mMetadata(new MetaDataList(type == GAME ? GAME_METADATA : FOLDER_METADATA)) // metadata is REALLY set in the constructor!
 {
 	// metadata needs at least a name field (since that's what getName() will return)
-	if (mMetadata.get(MetaDataId::Name).empty() && !mPath.empty())
-		mMetadata.set(MetaDataId::Name, getDisplayName());
+	if (mMetadata->get(MetaDataId::Name).empty() && !mPath.empty())
+		mMetadata->set(MetaDataId::Name, getDisplayName());
 	
-	mMetadata.resetChangedFlag();
+	mMetadata->resetChangedFlag();
+	mMetadata->setOwner(this);
+}
+
+FileData::FileData(FileType type, SystemData* system)
+	: mType(type), mSystem(system), mParent(nullptr), mDisplayName(nullptr), mNameCache(nullptr), mMetadata(nullptr)
+{
+
 }
 
 const std::string FileData::getPath() const
@@ -133,16 +144,33 @@ std::string FileData::getSystemName() const
 	return mSystem->getName();
 }
 
+void* FileData::operator new(size_t size)
+{
+	return FileDataPool::allocate(size);
+}
+
+void FileData::operator delete(void* ptr, size_t size)
+{
+	FileDataPool::deallocate(ptr, size);
+}
+
 FileData::~FileData()
 {
 	if (mDisplayName)
 		delete mDisplayName;
 
+	if (mNameCache)
+		delete mNameCache;
+
 	if (mParent)
 		mParent->removeChild(this);
 
-	if (mType == GAME)
+	// Collection entries have no metadata to unindex
+	if (mType == GAME && mMetadata != nullptr)
 		mSystem->removeFromIndex(this);
+
+	if (mMetadata)
+		delete mMetadata;
 }
 
 std::string& FileData::getDisplayName()
@@ -262,12 +290,12 @@ bool FileData::hasAnyMedia()
 	if (Utils::FileSystem::exists(getImagePath()) || Utils::FileSystem::exists(getThumbnailPath(false)) || Utils::FileSystem::exists(getVideoPath()))
 		return true;
 
-	for (auto mdd : mMetadata.getMDD())
+	for (auto mdd : MetaDataList::getMDD())
 	{
 		if (mdd.type != MetaDataType::MD_PATH)
 			continue;
 
-		std::string path = mMetadata.get(mdd.key);
+		std::string path = getMetadata().get(mdd.key);
 		if (path.empty())
 			continue;
 
@@ -293,7 +321,7 @@ std::vector<std::string> FileData::getFileMedias()
 {
 	std::vector<std::string> ret;
 
-	for (auto mdd : mMetadata.getMDD())
+	for (auto mdd : MetaDataList::getMDD())
 	{
 		if (mdd.type != MetaDataType::MD_PATH)
 			continue;
@@ -301,7 +329,7 @@ std::vector<std::string> FileData::getFileMedias()
 		if (mdd.id == MetaDataId::Video || mdd.id == MetaDataId::Manual || mdd.id == MetaDataId::Magazine)
 			continue;
 
-		std::string path = mMetadata.get(mdd.key);
+		std::string path = getMetadata().get(mdd.key);
 		if (path.empty())
 			continue;
 
@@ -315,9 +343,23 @@ std::vector<std::string> FileData::getFileMedias()
 	return ret;
 }
 
+unsigned int FileData::sSettingsGeneration = 0;
+
 void FileData::resetSettings() 
 {
-	
+	// The cached names are computed again
+	sSettingsGeneration++;
+}
+
+FileNameCache* FileData::getNameCache()
+{
+	if (mType != GAME)
+		return nullptr;
+
+	if (mNameCache == nullptr)
+		mNameCache = new FileNameCache();
+
+	return mNameCache;
 }
 
 const std::string& FileData::getName()
@@ -325,7 +367,7 @@ const std::string& FileData::getName()
 	if (mSystem != nullptr && mSystem->getShowFilenames())
 		return getDisplayName();
 
-	return mMetadata.getName();
+	return getMetadata().getName();
 }
 
 const std::string FileData::getVideoPath()
@@ -466,14 +508,6 @@ FileData* FileData::getSourceFileData()
 	return this;
 }
 
-static std::string formatCommandLineArgument(const std::string& name)
-{
-	if (name.find(" ") != std::string::npos)
-		return "\"" + Utils::String::replace(name, "\"", "\\\"") + "\"";
-
-	return Utils::String::replace(name, "\"", "\\\"");
-};
-
 std::string FileData::getlaunchCommand(LaunchGameOptions& options, bool includeControllers)
 {
 	FileData* gameToUpdate = getSourceFileData();
@@ -485,21 +519,23 @@ std::string FileData::getlaunchCommand(LaunchGameOptions& options, bool includeC
 		return "";
 
 	// must really;-) be done before window->deinit while it closes joysticks
-	std::string controllersConfig = InputManager::getInstance()->configureEmulators();
+	std::string controllersConfig = includeControllers ? InputManager::getInstance()->configureEmulators() : "%CONTROLLERSCONFIG%";
 
-	if (gameToUpdate->isLightGunGame())
-		controllersConfig = controllersConfig + "-lightgun ";
+	if (includeControllers)
+	{
+		if (gameToUpdate->isLightGunGame())
+			controllersConfig = controllersConfig + "-lightgun ";
 
-        if (gameToUpdate->isWheelGame())
-		controllersConfig = controllersConfig + "-wheel ";
+		if (gameToUpdate->isWheelGame())
+			controllersConfig = controllersConfig + "-wheel ";
 
-        if (gameToUpdate->isTrackballGame())
-		controllersConfig = controllersConfig + "-trackball ";
+		if (gameToUpdate->isTrackballGame())
+			controllersConfig = controllersConfig + "-trackball ";
 
-        if (gameToUpdate->isSpinnerGame())
-		controllersConfig = controllersConfig + "-spinner ";
+		if (gameToUpdate->isSpinnerGame())
+			controllersConfig = controllersConfig + "-spinner ";
+	}
 
-	std::string systemName = system->getName();
 	std::string emulator = getEmulator();
 	std::string core = getCore();
 
@@ -545,30 +581,17 @@ std::string FileData::getlaunchCommand(LaunchGameOptions& options, bool includeC
 		}
 	}*/
 	
-	std::string command = system->getLaunchCommand(emulator, core);
-
-	if (forceCore)
-	{
-		if (command.find("%EMULATOR%") == std::string::npos && command.find("-emulator") == std::string::npos)
-			command = command + " -emulator %EMULATOR%";
+	// The system, emulator & core parts are resolved once
+	auto launchTemplate = system->getLaunchCommandTemplate(emulator, core, forceCore);
 
-		if (command.find("%CORE%") == std::string::npos && command.find("-core") == std::string::npos)
-			command = command + " -core %CORE%";
-	}
+	std::string values[LaunchCommandTemplate::TOKEN_COUNT];
+	values[LaunchCommandTemplate::ROM] = Utils::FileSystem::getEscapedPath(getPath());
+	values[LaunchCommandTemplate::BASENAME] = Utils::FileSystem::getStem(getPath());
+	values[LaunchCommandTemplate::ROM_RAW] = Utils::FileSystem::getPreferredPath(getPath());
+	values[LaunchCommandTemplate::CONTROLLERSCONFIG] = controllersConfig;
 
-	const std::string rom = Utils::FileSystem::getEscapedPath(getPath());
-	const std::string basename = Utils::FileSystem::getStem(getPath());
-	const std::string rom_raw = Utils::FileSystem::getPreferredPath(getPath());
-	
-	command = Utils::String::replace(command, "%SYSTEM%", systemName);
-	command = Utils::String::replace(command, "%ROM%", rom);
-	command = Utils::String::replace(command, "%BASENAME%", basename);
-	command = Utils::String::replace(command, "%ROM_RAW%", rom_raw);
-	command = Utils::String::replace(command, "%EMULATOR%", emulator);
-	command = Utils::String::replace(command, "%CORE%", core);
-	command = Utils::String::replace(command, "%HOME%", Paths::getHomePath());
-	command = Utils::String::replace(command, "%GAMENAME%", formatCommandLineArgument(gameToUpdate->getName()));
-	command = Utils::String::replace(command, "%SYSTEMNAME%", formatCommandLineArgument(system->getFullName()));
+	if (launchTemplate->hasToken(LaunchCommandTemplate::GAMENAME))
+		values[LaunchCommandTemplate::GAMENAME] = LaunchCommandTemplate::formatArgument(gameToUpdate->getName());
 
 	// Export Game info XML is requested
 #ifdef WIN32
@@ -577,16 +600,12 @@ std::string FileData::getlaunchCommand(LaunchGameOptions& options, bool includeC
 	std::string fileInfo = "/tmp/game.xml";
 #endif
 
-	if (command.find("%GAMEINFOXML%") != std::string::npos && saveToXml(gameToUpdate, fileInfo, true))
-		command = Utils::String::replace(command, "%GAMEINFOXML%", Utils::FileSystem::getEscapedPath(fileInfo));
+	if (launchTemplate->hasToken(LaunchCommandTemplate::GAMEINFOXML) && saveToXml(gameToUpdate, fileInfo, true))
+		values[LaunchCommandTemplate::GAMEINFOXML] = Utils::FileSystem::getEscapedPath(fileInfo);
 	else
-	{
-		command = Utils::String::replace(command, "%GAMEINFOXML%", "");
 		Utils::FileSystem::removeFile(fileInfo);
-	}
-	
-	if (includeControllers)
-		command = Utils::String::replace(command, "%CONTROLLERSCONFIG%", controllersConfig);
+
+	std::string command = launchTemplate->format(values);
 
 	if (options.netPlayMode != DISABLED && (forceCore || gameToUpdate->isNetplaySupported()) && command.find("%NETPLAY%") == std::string::npos)
 		command = command + " %NETPLAY%"; // Add command line parameter if the netplay option is defined at <core netplay="true"> level
@@ -944,14 +963,14 @@ void FileData::deleteGameFiles()
 	if (path.empty() || getSystemEnvData()->mStartPath == path)
 		return;
 
-	for (auto mdd : mMetadata.getMDD())
+	for (auto mdd : MetaDataList::getMDD())
 	{
-		if (mMetadata.getType(mdd.id) != MetaDataType::MD_PATH)
+		if (getMetadata().getType(mdd.id) != MetaDataType::MD_PATH)
 			continue;
 
-		std::string path = mMetadata.get(mdd.id);
+		std::string path = getMetadata().get(mdd.id);
 		if (Utils::FileSystem::exists(path) && !Utils::FileSystem::isDirectory(path))
-			Utils::FileSystem::removeFile(mMetadata.get(mdd.id));
+			Utils::FileSystem::removeFile(getMetadata().get(mdd.id));
 	}
 
 	if (Utils::FileSystem::isDirectory(path))
@@ -967,7 +986,7 @@ void FileData::deleteGameFiles()
 }
 
 CollectionFileData::CollectionFileData(FileData* file, SystemData* system)
-	: FileData(file->getSourceFileData()->getType(), "", system)
+	: FileData(file->getSourceFileData()->getType(), system)
 {
 	mSourceFileData = file->getSourceFileData();
 	mParent = NULL;	
@@ -997,6 +1016,71 @@ CollectionFileData::~CollectionFileData()
 	mParent = NULL;
 }
 
+#define COLLECTION_FILE_DATA_BLOCK_COUNT	1024
+
+static std::mutex	sCollectionFileDataLock;
+static std::vector<void*> sCollectionFileDataBlocks;
+static void*		sCollectionFileDataFreeList = nullptr;
+static size_t		sCollectionFileDataCount = 0;
+
+void* CollectionFileData::operator new(size_t size)
+{
+	if (size != sizeof(CollectionFileData))
+		return ::operator new(size);
+
+	std::unique_lock<std::mutex> lock(sCollectionFileDataLock);
+
+	if (sCollectionFileDataFreeList == nullptr)
+	{
+		// The blocks are kept when the entries are deleted : they are reused when the collections are populated again
+		char* block = (char*) ::operator new(COLLECTION_FILE_DATA_BLOCK_COUNT * sizeof(CollectionFileData));
+		sCollectionFileDataBlocks.push_back(block);
+
+		for (int i = COLLECTION_FILE_DATA_BLOCK_COUNT - 1; i >= 0; i--)
+		{
+			void* entry = block + i * sizeof(CollectionFileData);
+			*(void**)entry = sCollectionFileDataFreeList;
+			sCollectionFileDataFreeList = entry;
+		}
+	}
+
+	void* ret = sCollectionFileDataFreeList;
+	sCollectionFileDataFreeList = *(void**)ret;
+	sCollectionFileDataCount++;
+	return ret;
+}
+
+void CollectionFileData::operator delete(void* ptr, size_t size)
+{
+	if (ptr == nullptr)
+		return;
+
+	if (size != sizeof(CollectionFileData))
+	{
+		::operator delete(ptr);
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(sCollectionFileDataLock);
+
+	*(void**)ptr = sCollectionFileDataFreeList;
+	sCollectionFileDataFreeList = ptr;
+	sCollectionFileDataCount--;
+}
+
+std::string CollectionFileData::getAllocationReport()
+{
+	std::unique_lock<std::mutex> lock(sCollectionFileDataLock);
+
+	size_t reserved = sCollectionFileDataBlocks.size() * COLLECTION_FILE_DATA_BLOCK_COUNT * sizeof(CollectionFileData);
+
+	char buffer[256];
+	snprintf(buffer, sizeof(buffer), "%d collection entries, %d bytes per entry, %d KB reserved",
+		(int)sCollectionFileDataCount, (int)sizeof(CollectionFileData), (int)(reserved / 1024));
+
+	return buffer;
+}
+
 std::string CollectionFileData::getKey() 
 {
 	return getFullPath();
@@ -1120,6 +1204,7 @@ const std::vector<FileData*> FolderData::getChildrenListToDisplay()
 		currentSortId = 0;
 
 	const FileSorts::SortType& sort = FileSorts::getSortTypes().at(currentSortId);
+	FileSorts::SortNameScope sortNames(ret, sort);
 
 	if (idx != nullptr && idx->hasRelevency())
 	{
@@ -1224,11 +1309,33 @@ FileData* FolderData::findUniqueGameForFolder()
 
 
 
-void FolderData::getFilesRecursiveWithContext(std::vector<FileData*>& out, unsigned int typeMask, GetFileContext* filter, bool displayedOnly, SystemData* system, bool includeVirtualStorage) const
+std::atomic<unsigned int> FolderData::sTreeGeneration(1);
+std::mutex FolderData::sFlatFileListLock;
+
+struct FlatFileEntry
 {
-	if (filter == nullptr)
-		return;
+	FileData*	file;
+	FolderData* folder; // The folder listing the file : its system filters it
+	bool		forced; // Listed whatever the type & the filters
+};
+
+// Files of the subtree in the order of the recursive walk, for each value of includeVirtualStorage, 
+// with the lists of the files by type. Rebuilt when the generation of the trees has changed
+struct FolderData::FlatFileList
+{
+	FlatFileList() 
+	{ 
+		generation[0] = generation[1] = 0; 
+	}
 
+	std::mutex lock;
+	unsigned int generation[2];
+	std::vector<FlatFileEntry> entries[2];
+	std::map<unsigned int, std::vector<FileData*>> byType[2];
+};
+
+void FolderData::buildFlatFileList(std::vector<FlatFileEntry>& out, bool includeVirtualStorage) const
+{
 	auto isVirtualFolder = [](FileData* file)
 	{
 		if (file->getType() == GAME)
@@ -1238,36 +1345,10 @@ void FolderData::getFilesRecursiveWithContext(std::vector<FileData*>& out, unsig
 		return fld->isVirtualStorage();
 	};
 
-	SystemData* pSystem = (system != nullptr ? system : mSystem);
-	
-	FileFilterIndex* idx = pSystem->getIndex(false);
-
 	for (auto it : mChildren)
 	{
-		if (it->getType() & typeMask)
-		{
-			if (!displayedOnly || idx == nullptr || !idx->isFiltered() || idx->showFile(it))
-			{
-				if (displayedOnly)
-				{
-					if (!filter->showHiddenFiles && it->getHidden())
-						continue;
-
-					if (filter->filterKidGame && !it->getKidGame())
-						continue;
-
-					if (typeMask == GAME && filter->hiddenExtensions.size() > 0)
-					{
-						std::string extlow = Utils::String::toLower(Utils::FileSystem::getExtension(it->getFileName(), false));
-						if (filter->hiddenExtensions.find(extlow) != filter->hiddenExtensions.cend())
-							continue;
-					}
-				}
-
-				if (includeVirtualStorage || !isVirtualFolder(it))
-					out.push_back(it);
-			}
-		}
+		if (includeVirtualStorage || !isVirtualFolder(it))
+			out.push_back(FlatFileEntry { it, (FolderData*) this, false });
 
 		if (it->getType() != FOLDER)
 			continue;
@@ -1278,20 +1359,120 @@ void FolderData::getFilesRecursiveWithContext(std::vector<FileData*>& out, unsig
 			if (includeVirtualStorage || !isVirtualFolder(folder))
 			{
 				if (folder->isVirtualStorage() && folder->getSourceFileData()->getSystem()->isGroupChildSystem() && folder->getSourceFileData()->getSystem()->getName() == "windows_installers")
-					out.push_back(it);
+					out.push_back(FlatFileEntry { it, (FolderData*) this, true });
 				else
-					folder->getFilesRecursiveWithContext(out, typeMask, filter, displayedOnly, system, includeVirtualStorage);
+					folder->buildFlatFileList(out, includeVirtualStorage);
 			}
 		}
 	}
 }
 
+void FolderData::onTreeChanged()
+{
+	sTreeGeneration++;
+}
+
 std::vector<FileData*> FolderData::getFlatGameList(bool displayedOnly, SystemData* system) const
 {
 	return getFilesRecursive(GAME, displayedOnly, system);
 }
 
+bool FolderData::isFileDisplayed(FileData* file, const GetFileContext* ctx, FileFilterIndex* index, unsigned int typeMask)
+{
+	if (index != nullptr && index->isFiltered() && !index->showFile(file))
+		return false;
+
+	if (!ctx->showHiddenFiles && file->getHidden())
+		return false;
+
+	if (ctx->filterKidGame && !file->getKidGame())
+		return false;
+
+	if (typeMask == GAME && ctx->hiddenExtensions.size() > 0)
+	{
+		std::string extlow = Utils::String::toLower(Utils::FileSystem::getExtension(file->getFileName(), false));
+		if (ctx->hiddenExtensions.find(extlow) != ctx->hiddenExtensions.cend())
+			return false;
+	}
+
+	return true;
+}
+
 std::vector<FileData*> FolderData::getFilesRecursive(unsigned int typeMask, bool displayedOnly, SystemData* system, bool includeVirtualStorage) const
+{
+	FlatFileList* flatFiles;
+
+	{
+		std::unique_lock<std::mutex> lock(sFlatFileListLock);
+		if (mFlatFiles == nullptr)
+			mFlatFiles = new FlatFileList();
+
+		flatFiles = mFlatFiles;
+	}
+
+	int list = includeVirtualStorage ? 1 : 0;
+
+	std::unique_lock<std::mutex> lock(flatFiles->lock);
+
+	unsigned int generation = sTreeGeneration;
+	if (flatFiles->generation[list] != generation)
+	{
+		flatFiles->entries[list].clear();
+		flatFiles->byType[list].clear();
+		buildFlatFileList(flatFiles->entries[list], includeVirtualStorage);
+		flatFiles->generation[list] = generation;
+	}
+
+	auto& entries = flatFiles->entries[list];
+
+	if (!displayedOnly)
+	{
+		auto it = flatFiles->byType[list].find(typeMask);
+		if (it != flatFiles->byType[list].cend())
+			return it->second;
+
+		std::vector<FileData*> out;
+		for (auto& entry : entries)
+			if (entry.forced || (entry.file->getType() & typeMask))
+				out.push_back(entry.file);
+
+		flatFiles->byType[list][typeMask] = out;
+		return out;
+	}
+
+	GetFileContext ctx = getFileContext(system);
+
+	FolderData* folder = nullptr;
+	FileFilterIndex* idx = nullptr;
+
+	std::vector<FileData*> out;
+	out.reserve(entries.size());
+
+	for (auto& entry : entries)
+	{
+		if (entry.forced)
+		{
+			out.push_back(entry.file);
+			continue;
+		}
+
+		if ((entry.file->getType() & typeMask) == 0)
+			continue;
+
+		if (entry.folder != folder)
+		{
+			folder = entry.folder;
+			idx = (system != nullptr ? system : folder->mSystem)->getIndex(false);
+		}
+
+		if (isFileDisplayed(entry.file, &ctx, idx, typeMask))
+			out.push_back(entry.file);
+	}
+
+	return out;
+}
+
+GetFileContext FolderData::getFileContext(SystemData* system) const
 {
 	SystemData* pSystem = (system != nullptr ? system : mSystem);
 	
@@ -1312,10 +1493,7 @@ std::vector<FileData*> FolderData::getFilesRecursive(unsigned int typeMask, bool
 	}
 
 	ctx.filterKidGame = UIModeController::getInstance()->isUIModeKid();
-
-	std::vector<FileData*> out;
-	getFilesRecursiveWithContext(out, typeMask, &ctx, displayedOnly, system, includeVirtualStorage);
-	return out;
+	return ctx;
 }
 
 void FolderData::addChild(FileData* file, bool assignParent)
@@ -1328,6 +1506,9 @@ void FolderData::addChild(FileData* file, bool assignParent)
 
 	if (assignParent)
 		file->setParent(this);	
+
+	updatePathIndexes(file, true);
+	onTreeChanged();
 }
 
 void FolderData::removeChild(FileData* file)
@@ -1340,9 +1521,11 @@ void FolderData::removeChild(FileData* file)
 	auto it = std::find(mChildren.begin(), mChildren.end(), file);
 	if (it != mChildren.end())
 	{
+		updatePathIndexes(file, false);
 		file->setParent(nullptr);
 		std::iter_swap(it, mChildren.end() - 1);
 		mChildren.pop_back();
+		onTreeChanged();
 	}
 
 	// File somehow wasn't in our children.
@@ -1357,10 +1540,11 @@ void FolderData::bulkRemoveChildren(std::vector<FileData*>& mChildren, const std
 		std::remove_if(
 			mChildren.begin(),
 			mChildren.end(),
-			[&filesToRemove](FileData* file)
+			[this, &filesToRemove](FileData* file)
 			{
 				if (filesToRemove.count(file))
 				{
+					updatePathIndexes(file, false);
 					file->setParent(nullptr);
 					return true;
 				}
@@ -1369,31 +1553,103 @@ void FolderData::bulkRemoveChildren(std::vector<FileData*>& mChildren, const std
 		),
 		mChildren.end()
 	);
+
+	onTreeChanged();
 }
 
-FileData* FolderData::FindByPath(const std::string& path)
+static void getSubTree(FileData* file, std::vector<FileData*>& out)
 {
-	std::stack<FileData*> stack;	
-	for (FileData* c : mChildren)
-		if (c != nullptr)
-			stack.push(c);
+	std::stack<FileData*> stack;
+	stack.push(file);
 
 	while (!stack.empty())
 	{
 		FileData* item = stack.top();
 		stack.pop();
 
-		if (item->getPath() == path)
-			return item;
+		out.push_back(item);
 
 		if (item->getType() != FOLDER)
 			continue;
 
-		const auto& sub = static_cast<FolderData*>(item)->mChildren;
-		for (FileData* s : sub)
+		for (FileData* s : static_cast<FolderData*>(item)->getChildren())
 			if (s != nullptr)
 				stack.push(s);
 	}
+}
+
+void FolderData::updatePathIndexes(FileData* file, bool add)
+{
+	if (file == nullptr)
+		return;
+
+	std::vector<FileData*> files;
+
+	// The subtree is listed once, only if this folder or one of its parents is indexed
+	for (FolderData* folder = this; folder != nullptr; folder = folder->getParent())
+	{
+		if (folder->mPathIndex == nullptr)
+			continue;
+
+		if (files.empty())
+			getSubTree(file, files);
+
+		for (auto item : files)
+		{
+			size_t hash = std::hash<std::string>()(item->getPath());
+
+			if (add)
+			{
+				folder->mPathIndex->insert(std::make_pair(hash, item));
+				continue;
+			}
+
+			// A file can be there more than once (virtual folders) : remove a single occurence
+			auto range = folder->mPathIndex->equal_range(hash);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (it->second == item)
+				{
+					folder->mPathIndex->erase(it);
+					break;
+				}
+			}
+		}
+	}
+}
+
+void FolderData::resetPathIndexes()
+{
+	for (FolderData* folder = this; folder != nullptr; folder = folder->getParent())
+	{
+		if (folder->mPathIndex != nullptr)
+		{
+			delete folder->mPathIndex;
+			folder->mPathIndex = nullptr;
+		}
+	}
+}
+
+FileData* FolderData::FindByPath(const std::string& path)
+{
+	if (mPathIndex == nullptr)
+	{
+		std::vector<FileData*> files;
+		for (FileData* c : mChildren)
+			if (c != nullptr)
+				getSubTree(c, files);
+
+		mPathIndex = new std::unordered_multimap<size_t, FileData*>();
+		mPathIndex->reserve(files.size());
+
+		for (auto item : files)
+			mPathIndex->insert(std::make_pair(std::hash<std::string>()(item->getPath()), item));
+	}
+
+	auto range = mPathIndex->equal_range(std::hash<std::string>()(path));
+	for (auto it = range.first; it != range.second; ++it)
+		if (it->second->getPath() == path)
+			return it->second;
 
 	return nullptr;
 }
@@ -1550,9 +1806,9 @@ void FileData::detectLanguageAndRegion(bool overWrite)
 
 	auto info = LangInfo::parse(getSourceFileData()->getPath(), getSourceFileData()->getSystem());
 	if (info.languages.size() > 0)
-		mMetadata.set(MetaDataId::Language, info.getLanguageString());
+		getMetadata().set(MetaDataId::Language, info.getLanguageString());
 	if (!info.region.empty())
-		mMetadata.set(MetaDataId::Region, info.region);
+		getMetadata().set(MetaDataId::Region, info.region);
 }
 
 void FolderData::removeVirtualFolders() {
@@ -1771,14 +2027,24 @@ FolderData::FolderData(const std::string& startpath, SystemData* system, bool ow
 {
 	mIsDisplayableAsVirtualFolder = false;
 	mOwnsChildrens = ownsChildrens;
+	mPathIndex = nullptr;
+	mFlatFiles = nullptr;
 }
 
 FolderData::~FolderData()
 {
 	clear();
+
+	if (mPathIndex != nullptr)
+		delete mPathIndex;
+
+	if (mFlatFiles != nullptr)
+		delete mFlatFiles;
 }
 
 void FolderData::clear() {
+	resetPathIndexes();
+
 	if (mOwnsChildrens)
 		for (auto* child : mChildren)
 		{
@@ -1786,6 +2052,7 @@ void FolderData::clear() {
 			delete child;
 		}
 	mChildren.clear();
+	onTreeChanged();
 }
 
 void FolderData::removeFromVirtualFolders(FileData* game)
@@ -1800,7 +2067,9 @@ void FolderData::removeFromVirtualFolders(FileData* game)
 
 		if ((*it) == game)
 		{
+			updatePathIndexes(game, false);
 			mChildren.erase(it);
+			onTreeChanged();
 			return;
 		}
 	}
@@ -9,12 +9,16 @@
 #include <memory>
 #include <vector>
 #include <stack>
+#include <atomic>
+#include <mutex>
 #include "KeyboardMapping.h"
 #include "SystemData.h"
 #include "SaveState.h"
 #include "BindingManager.h"
 
 class Window;
+class FileFilterIndex;
+struct FlatFileEntry;
 struct SystemEnvironmentData;
 
 
@@ -72,6 +76,20 @@ struct LaunchGameOptions
 
 class FolderData;
 
+// Display name formatted by GameNameFormatter::getDisplayName, kept while its metadata and the settings are unchanged.
+// Only used by the UI thread, and created for the games when they're first displayed
+struct FileNameCache
+{
+	FileNameCache() : displayKey(0), displayVersion(0), displayGeneration(0), displaySaveStates(false), displayValid(false) { }
+
+	unsigned long long displayKey;
+	unsigned int displayVersion;
+	unsigned int displayGeneration;
+	bool displaySaveStates;
+	bool displayValid;
+	std::string displayName;
+};
+
 // A tree node that holds information for a file.
 class FileData : public IKeyboardMapContainer, public IBindable
 {
@@ -79,6 +97,10 @@ public:
 	FileData(FileType type, const std::string& path, SystemData* system);
 	virtual ~FileData();
 
+	// Allocated from the pool of the system being loaded, see FileDataPool
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr, size_t size);
+
 	static FileData* GetRunningGame() { return mRunningGame; }
 
 	virtual const std::string& getName();
@@ -144,9 +166,12 @@ public:
 	bool		launchGame(Window* window, LaunchGameOptions options = LaunchGameOptions());
 
 	static void resetSettings();
+	static unsigned int getSettingsGeneration() { return sSettingsGeneration; }
+
+	FileNameCache* getNameCache(); // nullptr if it's not a game
 	
-	virtual const MetaDataList& getMetadata() const { return mMetadata; }
-	virtual MetaDataList& getMetadata() { return mMetadata; }
+	virtual const MetaDataList& getMetadata() const { return *mMetadata; }
+	virtual MetaDataList& getMetadata() { return *mMetadata; }
 
 	void setMetadata(MetaDataList value) { getMetadata() = value; } 
 	
@@ -190,9 +215,12 @@ public:
 private:
 	std::string getKeyboardMappingFilePath();
 	std::string getMessageFromExitCode(int exitCode);
-	MetaDataList mMetadata;
+	MetaDataList* mMetadata;
 
 protected:	
+	// For files which have no metadata of their own
+	FileData(FileType type, SystemData* system);
+
 	std::string  findLocalArt(const std::string& type = "", std::vector<std::string> exts = { ".png", ".jpg" });
 
 	static FileData* mRunningGame;
@@ -202,6 +230,9 @@ protected:
 	FileType mType;
 	SystemData* mSystem;
 	std::string* mDisplayName;
+	FileNameCache* mNameCache;
+
+	static unsigned int sSettingsGeneration;
 };
 
 class CollectionFileData : public FileData
@@ -221,6 +252,12 @@ public:
 	virtual MetaDataList& getMetadata() { return mSourceFileData->getMetadata(); }
 	virtual std::string& getDisplayName() { return mSourceFileData->getDisplayName(); }
 
+	// Entries are allocated by blocks from a shared pool, and have no metadata nor path of their own
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr, size_t size);
+
+	static std::string getAllocationReport();
+
 private:
 	// needs to be updated when metadata changes
 	FileData* mSourceFileData;
@@ -250,6 +287,10 @@ public:
 	std::vector<FileData*> getFilesRecursive(unsigned int typeMask, bool displayedOnly = false, SystemData* system = nullptr, bool includeVirtualStorage = true) const;
 	std::vector<FileData*> getFlatGameList(bool displayedOnly, SystemData* system) const;
 
+	// Rules used by getFilesRecursive when displayedOnly is set
+	GetFileContext getFileContext(SystemData* system = nullptr) const;
+	static bool isFileDisplayed(FileData* file, const GetFileContext* ctx, FileFilterIndex* index, unsigned int typeMask = GAME);
+
 	void addChild(FileData* file, bool assignParent = true); // Error if mType != FOLDER
 	void removeChild(FileData* file); //Error if mType != FOLDER
 	void bulkRemoveChildren(std::vector<FileData*>& mChildren, const std::unordered_set<FileData*>& filesToRemove); //Error if mType != FOLDER
@@ -262,13 +303,28 @@ public:
 	void removeVirtualFolders();
 	void removeFromVirtualFolders(FileData* game);
 
+	// To call when children are changed directly (sorted...) : the cached file lists are rebuilt
+	static void onTreeChanged();
+
 private:
-	void getFilesRecursiveWithContext(std::vector<FileData*>& out, unsigned int typeMask, GetFileContext* filter, bool displayedOnly, SystemData* system, bool includeVirtualStorage) const;
+	struct FlatFileList;
+	void buildFlatFileList(std::vector<FlatFileEntry>& out, bool includeVirtualStorage) const;
 
+	void updatePathIndexes(FileData* file, bool add);
+	void resetPathIndexes();
 
 	std::vector<FileData*> mChildren;
 	bool	mOwnsChildrens;
 	bool	mIsDisplayableAsVirtualFolder;
+
+	// Path hash -> files of the whole subtree. Built by the first FindByPath, then kept up to date when children are added or removed
+	std::unordered_multimap<size_t, FileData*>* mPathIndex;
+
+	// Flattened subtree used by getFilesRecursive, valid while the trees are unchanged
+	mutable FlatFileList* mFlatFiles;
+
+	static std::atomic<unsigned int> sTreeGeneration;
+	static std::mutex sFlatFileListLock;
 };
 
 #endif // ES_APP_FILE_DATA_H
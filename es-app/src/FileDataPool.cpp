@@ -0,0 +1,200 @@
+#include "FileDataPool.h"
+
+#include <cstddef>
+#include <stdio.h>
+
+#define FILE_DATA_POOL_BLOCK_SIZE	(64 * 1024)
+#define FILE_DATA_POOL_ALIGNMENT	alignof(std::max_align_t)
+#define FILE_DATA_POOL_ALIGN(x)		(((x) + FILE_DATA_POOL_ALIGNMENT - 1) & ~(FILE_DATA_POOL_ALIGNMENT - 1))
+
+// Each entry starts with the pool it comes from (nullptr for the heap), so delete can give it back.
+// It's padded so the object keeps the alignment of operator new.
+#define FILE_DATA_POOL_HEADER_SIZE	FILE_DATA_POOL_ALIGN(sizeof(void*))
+
+thread_local FileDataPool::Scope* FileDataPool::sCurrent = nullptr;
+
+std::atomic<int> FileDataPool::sPooledObjects(0);
+std::atomic<int> FileDataPool::sHeapObjects(0);
+std::atomic<int> FileDataPool::sBlocks(0);
+
+FileDataPool::FileDataPool() : mReferences(1)
+{
+
+}
+
+FileDataPool::~FileDataPool()
+{
+	for (auto block : mBlocks)
+		::operator delete(block);
+}
+
+void FileDataPool::release()
+{
+	// Some objects may have moved to another tree : the last one deletes the pool
+	unref();
+}
+
+void FileDataPool::unref()
+{
+	if (--mReferences == 0)
+		delete this;
+}
+
+FileDataPool::Scope::Scope(FileDataPool* pool) : mPool(pool)
+{
+	if (mPool != nullptr)
+		mPool->mReferences++;
+
+	mPrevious = sCurrent;
+	sCurrent = this;
+}
+
+FileDataPool::Scope::~Scope()
+{
+	sCurrent = mPrevious;
+
+	if (mPool == nullptr)
+		return;
+
+	for (auto& list : mFreeLists)
+		if (list.head != nullptr)
+			mPool->giveEntries(list.size, list.head);
+
+	mPool->unref();
+}
+
+void* FileDataPool::Scope::allocateEntry(size_t size)
+{
+	FreeList* freeList = getFreeList(mFreeLists, size);
+	if (freeList->head == nullptr)
+		freeList->head = mPool->takeEntries(size);
+
+	void* ret = freeList->head;
+	freeList->head = *(void**)ret;
+	mPool->mReferences++;
+	return ret;
+}
+
+void* FileDataPool::allocate(size_t size)
+{
+	Scope* scope = sCurrent;
+	FileDataPool* pool = scope != nullptr ? scope->mPool : nullptr;
+
+	char* entry;
+
+	if (pool != nullptr)
+	{
+		entry = (char*)scope->allocateEntry(FILE_DATA_POOL_ALIGN(size + FILE_DATA_POOL_HEADER_SIZE));
+		sPooledObjects++;
+	}
+	else
+	{
+		entry = (char*) ::operator new(size + FILE_DATA_POOL_HEADER_SIZE);
+		sHeapObjects++;
+	}
+
+	*(FileDataPool**)entry = pool;
+	return entry + FILE_DATA_POOL_HEADER_SIZE;
+}
+
+void FileDataPool::deallocate(void* ptr, size_t size)
+{
+	if (ptr == nullptr)
+		return;
+
+	char* entry = (char*)ptr - FILE_DATA_POOL_HEADER_SIZE;
+
+	FileDataPool* pool = *(FileDataPool**)entry;
+	if (pool == nullptr)
+	{
+		::operator delete(entry);
+		return;
+	}
+
+	size = FILE_DATA_POOL_ALIGN(size + FILE_DATA_POOL_HEADER_SIZE);
+
+	// Inside a scope of the same pool, the entry goes back to the scope without locking
+	Scope* scope = sCurrent;
+	if (scope != nullptr && scope->mPool == pool)
+	{
+		FreeList* freeList = getFreeList(scope->mFreeLists, size);
+		*(void**)entry = freeList->head;
+		freeList->head = entry;
+	}
+	else
+	{
+		*(void**)entry = nullptr;
+		pool->giveEntries(size, entry);
+	}
+
+	pool->unref();
+}
+
+FileDataPool::FreeList* FileDataPool::getFreeList(std::vector<FreeList>& freeLists, size_t size)
+{
+	for (auto& list : freeLists)
+		if (list.size == size)
+			return &list;
+
+	freeLists.push_back(FreeList { size, nullptr });
+	return &freeLists.back();
+}
+
+// Returns all the free entries of this size, or a new block of them
+void* FileDataPool::takeEntries(size_t size)
+{
+	std::unique_lock<std::mutex> lock(mLock);
+
+	FreeList* freeList = getFreeList(mFreeLists, size);
+	if (freeList->head != nullptr)
+	{
+		void* ret = freeList->head;
+		freeList->head = nullptr;
+		return ret;
+	}
+
+	size_t count = FILE_DATA_POOL_BLOCK_SIZE / size;
+	if (count == 0)
+		count = 1;
+
+	char* block = (char*) ::operator new(count * size);
+	mBlocks.push_back(block);
+	sBlocks++;
+
+	void* head = nullptr;
+	for (size_t i = count; i > 0; i--)
+	{
+		void* entry = block + (i - 1) * size;
+		*(void**)entry = head;
+		head = entry;
+	}
+
+	return head;
+}
+
+void FileDataPool::giveEntries(size_t size, void* head)
+{
+	void* tail = head;
+	while (*(void**)tail != nullptr)
+		tail = *(void**)tail;
+
+	std::unique_lock<std::mutex> lock(mLock);
+
+	FreeList* freeList = getFreeList(mFreeLists, size);
+	*(void**)tail = freeList->head;
+	freeList->head = head;
+}
+
+std::string FileDataPool::getStatistics()
+{
+	char buffer[256];
+	snprintf(buffer, sizeof(buffer), "%d pooled objects in %d blocks, %d heap objects", (int)sPooledObjects, (int)sBlocks, (int)sHeapObjects);
+	return buffer;
+}
+
+void FileDataPool::resetStatistics()
+{
+	sPooledObjects = 0;
+	sHeapObjects = 0;
+	sBlocks = 0;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#ifndef ES_APP_FILE_DATA_POOL_H
+#define ES_APP_FILE_DATA_POOL_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Pool of the FileData, FolderData & MetaDataList objects of a system tree.
+// The objects are allocated by blocks instead of one by one, and the blocks are released together when the system is deleted.
+// Objects created outside of a Scope come from the heap, as usual.
+class FileDataPool
+{
+	struct FreeList
+	{
+		size_t size;
+		void*  head;
+	};
+
+public:
+	FileDataPool();
+
+	// Called by the system owning the pool : the pool is deleted once its last object is released
+	void release();
+
+	// While a scope is active, the pooled objects created by the current thread come from the pool.
+	// The scope keeps its own free entries, so the pool is only locked to get a new batch of them.
+	class Scope
+	{
+	public:
+		Scope(FileDataPool* pool);
+		~Scope();
+
+	private:
+		friend class FileDataPool;
+
+		void* allocateEntry(size_t size);
+
+		FileDataPool*			mPool;
+		Scope*					mPrevious;
+		std::vector<FreeList>	mFreeLists;
+	};
+
+	static void* allocate(size_t size);
+	static void deallocate(void* ptr, size_t size);
+
+	// Allocation counts since the last reset, to compare with one heap allocation per object
+	static std::string getStatistics();
+	static void resetStatistics();
+
+private:
+	~FileDataPool();
+
+	static FreeList* getFreeList(std::vector<FreeList>& freeLists, size_t size);
+
+	void* takeEntries(size_t size);
+	void giveEntries(size_t size, void* head);
+	void unref();
+
+	std::mutex				mLock;
+	std::vector<FreeList>	mFreeLists;
+	std::vector<void*>		mBlocks;
+	std::atomic<size_t>		mReferences; // Live objects, active scopes & the owning system
+
+	static thread_local Scope* sCurrent;
+
+	static std::atomic<int> sPooledObjects;
+	static std::atomic<int> sHeapObjects;
+	static std::atomic<int> sBlocks;
+};
+
+#endif // ES_APP_FILE_DATA_POOL_H
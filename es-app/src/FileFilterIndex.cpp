@@ -94,6 +94,8 @@ void FileFilterIndex::copyFrom(FileFilterIndex* indexToImport)
 
 		*src->second.filteredByRef = *decl.second.filteredByRef;
 	}
+
+	updateFilteredGenres();
 }
 
 void FileFilterIndex::importIndex(FileFilterIndex* indexToImport)
@@ -491,12 +493,20 @@ void FileFilterIndex::setFilter(FilterIndexType type, std::vector<std::string>*
 	*(filterData.filteredByRef) = values != nullptr && values->size() > 0;
 	filterData.currentFilteredKeys->clear();
 
-	if (values == nullptr)
-		return;
+	if (values != nullptr)
+	{
+		for (auto value : *values)
+			if (filterData.allIndexKeys->find(value) != filterData.allIndexKeys->cend()) // check if exists
+				filterData.currentFilteredKeys->insert(value);
+	}
 
-	for(auto value : *values)
-		if (filterData.allIndexKeys->find(value) != filterData.allIndexKeys->cend()) // check if exists
-			filterData.currentFilteredKeys->insert(value);	
+	if (type == GENRE_FILTER)
+		updateFilteredGenres();
+}
+
+void FileFilterIndex::updateFilteredGenres()
+{
+	mFilteredGenres = Genres::getGenreSet(genreIndexFilteredKeys);
 }
 
 std::unordered_set<std::string>* FileFilterIndex::getFilter(FilterIndexType type)
@@ -524,7 +534,8 @@ void FileFilterIndex::clearAllFilters()
 		*(filterData.filteredByRef) = false;
 		filterData.currentFilteredKeys->clear();
 	}
-	return;
+
+	updateFilteredGenres();
 }
 
 void FileFilterIndex::resetFilters()
@@ -893,14 +904,9 @@ int FileFilterIndex::showFile(FileData* game)
 		}
 		else if (filterData.type == GENRE_FILTER)
 		{
-			for (auto val : Genres::getGenreFiltersNames(&game->getMetadata()))
-			{
-				if (isKeyBeingFilteredBy(val, filterData.type))
-				{
-					filterValid = true;
-					break;
-				}
-			}
+			auto& genres = Genres::getGenreSet(&game->getMetadata());
+			if (genres.any())
+				filterValid = genres.intersects(mFilteredGenres);
 		}
 		else if (filterData.type == PLAYER_FILTER)
 		{
@@ -1223,6 +1229,8 @@ bool CollectionFilter::load(const std::string file)
 			tagIndexFilteredKeys.insert(node.text().as_string());
 	}
 
+	updateFilteredGenres();
+
 	for (auto& it : mFilterDecl)
 	{
 		FilterDataDecl& filterData = it.second;
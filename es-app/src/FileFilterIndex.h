@@ -6,6 +6,7 @@
 #include <vector>
 #include <unordered_set>
 #include <string>
+#include "Genres.h"
 
 class FileData;
 class SystemData;
@@ -93,6 +94,9 @@ protected:
 
 	std::string getIndexableKey(FileData* game, FilterIndexType type, bool getSecondary);
 
+	// Must be called when genreIndexFilteredKeys changes
+	void updateFilteredGenres();
+
 	void manageGenreEntryInIndex(FileData* game, bool remove = false);
 	void manageFamilyEntryInIndex(FileData* game, bool remove = false);
 	void managePlayerEntryInIndex(FileData* game, bool remove = false);
@@ -168,6 +172,8 @@ protected:
 	std::unordered_set<std::string> hasMediaIndexFilteredKeys;
 	std::unordered_set<std::string> missingMediaIndexFilteredKeys;
 
+	GenreSet mFilteredGenres;
+
 	std::string mTextFilter;
 	bool		mUseRelevency;
 };
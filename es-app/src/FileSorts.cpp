@@ -71,23 +71,61 @@ namespace FileSorts
 		mSortTypes.push_back(SortType(RELEASEDATE_SYSTEM_DESCENDING, &compareReleaseYearSystem, false, _("RELEASE YEAR, SYSTEM, DESCENDING"), _U("\uF161 ")));
 	}
 
-	//returns if file1 should come before file2
-	bool compareName(const FileData* file1, const FileData* file2)
-	{
-		// we compare the actual metadata name, as collection files have the system appended which messes up the order
-		const std::string& name1 = file1->getSortName();
-		const std::string& name2 = file2->getSortName();
+	static thread_local SortNameScope* sSortNameScope = nullptr;
 
+	// we compare the actual metadata name, as collection files have the system appended which messes up the order
+	static std::string getSortKey(const FileData* file)
+	{
 		if (Settings::IgnoreLeadingArticles())
 		{
 			static auto articles = Utils::String::commaStringToVector(_("A,AN,THE"));
-			auto name1a = stripLeadingArticle(name1, articles);
-			auto name2a = stripLeadingArticle(name2, articles);
+			return stripLeadingArticle(file->getSortName(), articles);
+		}
+
+		return file->getSortName();
+	}
+
+	SortNameScope::SortNameScope(const std::vector<FileData*>& files, const SortType& sort)
+	{
+		if (sort.comparisonFunction == &compareName)
+		{
+			mNames.reserve(files.size());
+
+			for (auto file : files)
+				mNames[file] = getSortKey(file);
+		}
+
+		mPrevious = sSortNameScope;
+		sSortNameScope = this;
+	}
+
+	SortNameScope::~SortNameScope()
+	{
+		sSortNameScope = mPrevious;
+	}
+
+	const std::string* SortNameScope::find(const FileData* file) const
+	{
+		auto it = mNames.find(file);
+		if (it == mNames.cend())
+			return nullptr;
+
+		return &it->second;
+	}
+
+	//returns if file1 should come before file2
+	bool compareName(const FileData* file1, const FileData* file2)
+	{
+		if (sSortNameScope != nullptr)
+		{
+			const std::string* name1 = sSortNameScope->find(file1);
+			const std::string* name2 = sSortNameScope->find(file2);
 
-			return Utils::String::compareIgnoreCase(name1a, name2a) < 0;
+			if (name1 != nullptr && name2 != nullptr)
+				return Utils::String::compareIgnoreCase(*name1, *name2) < 0;
 		}
 
-		return Utils::String::compareIgnoreCase(name1, name2) < 0;
+		return Utils::String::compareIgnoreCase(getSortKey(file1), getSortKey(file2)) < 0;
 	}
 
 	std::string stripLeadingArticle(const std::string &string, const std::vector<std::string> &articles)
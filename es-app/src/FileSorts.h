@@ -3,6 +3,7 @@
 #define ES_APP_FILE_SORTS_H
 
 #include "FileData.h"
+#include <unordered_map>
 #include <vector>
 
 namespace FileSorts
@@ -54,6 +55,21 @@ namespace FileSorts
 			: id(sortId), comparisonFunction(sortFunction), ascending(sortAscending), description(sortDescription), icon(iconId) {}
 	};
 
+	// Sort names of the files computed once before a sort by name, instead of twice per comparison.
+	// compareName uses the scope created by the current thread.
+	class SortNameScope
+	{
+	public:
+		SortNameScope(const std::vector<FileData*>& files, const SortType& sort);
+		~SortNameScope();
+
+		const std::string* find(const FileData* file) const;
+
+	private:
+		std::unordered_map<const FileData*, std::string> mNames;
+		SortNameScope* mPrevious;
+	};
+
 	class Singleton
 	{
 	public:
@@ -13,8 +13,8 @@
 #include <set>
 
 std::vector<GameGenre*> Genres::mGameGenres;
-std::map<int, GameGenre*> Genres::mGenres;
-std::map<std::string, int> Genres::mAllGenresNames;
+std::unordered_map<int, GameGenre*> Genres::mGenres;
+std::unordered_map<std::string, int> Genres::mAllGenresNames;
 
 void Genres::init()
 {
@@ -100,6 +100,8 @@ void Genres::init()
 			}
 		}
 
+		genre->index = (int)mGameGenres.size();
+
 		mGenres[genre->id] = genre;
 		mGameGenres.push_back(genre);
 	}
@@ -231,29 +233,75 @@ std::string& GameGenre::getLocalizedName()
 	return nom_en;
 }
 
-std::vector<std::string> Genres::getGenreFiltersNames(MetaDataList* game)
+const GenreSet& Genres::getGenreSet(MetaDataList* game)
 {
-	std::vector<std::string> ret;
+	GenreCache* cache = game->getGenreCache();
+	if (cache->valid && cache->version == game->getVersion())
+		return cache->genres;
 
-	auto ids = Utils::String::split(game->get(MetaDataId::GenreIds), ',', true);
-	for (auto id : ids)
+	cache->genres.reset();
+
+	std::string ids = game->get(MetaDataId::GenreIds);
+
+	// Parse the ids in place, GenreIds is a list like "12,258"
+	int id = 0;
+	for (size_t i = 0; i <= ids.size(); i++)
 	{
-		auto g = mGenres.find(Utils::String::toInteger(id));
+		char c = i < ids.size() ? ids[i] : ',';
+		if (c >= '0' && c <= '9')
+		{
+			id = id * 10 + (c - '0');
+			continue;
+		}
+
+		if (c != ',' || id == 0)
+			continue;
+
+		auto g = mGenres.find(id);
 		if (g != mGenres.cend())
 		{
-			if (g->second->parent != nullptr)
-			{
-				ret.push_back(std::to_string(g->second->parent->id));
-				ret.push_back(std::to_string(g->second->id));
-			}
-			else
-				ret.push_back(std::to_string(g->second->id));
+			cache->genres.set(g->second->index);
+			if (g->second->parent != nullptr && g->second->parent->index >= 0)
+				cache->genres.set(g->second->parent->index);
 		}
+
+		id = 0;
+	}
+
+	cache->version = game->getVersion();
+	cache->valid = true;
+	return cache->genres;
+}
+
+GenreSet Genres::getGenreSet(const std::unordered_set<std::string>& ids)
+{
+	GenreSet ret;
+
+	for (auto& id : ids)
+	{
+		auto g = mGenres.find(Utils::String::toInteger(id));
+		if (g != mGenres.cend())
+			ret.set(g->second->index);
 	}
 
 	return ret;
 }
 
+std::vector<std::string> Genres::getGenreFiltersNames(MetaDataList* game)
+{
+	std::vector<std::string> ret;
+
+	auto& genres = getGenreSet(game);
+	if (genres.none())
+		return ret;
+
+	for (auto genre : mGameGenres)
+		if (genres.test(genre->index))
+			ret.push_back(std::to_string(genre->id));
+
+	return ret;
+}
+
 std::string Genres::genreStringFromIds(const std::vector<std::string>& ids, bool localized)
 {
 	std::vector<std::string> ret;
@@ -302,7 +350,7 @@ GameGenre* Genres::fromGenreName(const std::string& name)
 		{
 			auto sg = mAllGenresNames.find(Utils::String::trim(subgenre));
 			if (sg != mAllGenresNames.cend())
-				return mGenres[g->second];
+				return mGenres[sg->second];
 		}
 	}
 
@@ -311,13 +359,11 @@ GameGenre* Genres::fromGenreName(const std::string& name)
 
 bool Genres::genreExists(MetaDataList* file, int id)
 {
-	auto idToFind = std::to_string(id);
-
-	for (auto id : getGenreFiltersNames(file))
-		if (id == idToFind)
-			return true;
+	auto g = mGenres.find(id);
+	if (g == mGenres.cend())
+		return false;
 
-	return false;
+	return getGenreSet(file).test(g->second->index);
 }
 
 void Genres::convertGenreToGenreIds(MetaDataList* file)
@@ -5,7 +5,8 @@
 
 #include <string>
 #include <vector>
-#include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 #define GENRE_LIGHTGUN  32
 #define GENRE_WHEEL     33
@@ -15,16 +16,84 @@
 
 class MetaDataList;
 
+// Genres of a game, by GameGenre::index. The parents of the subgenres are included.
+// Grows with the indexes that are set, so it's not limited to a fixed genre count.
+class GenreSet
+{
+public:
+	void set(int index)
+	{
+		if (index < 0)
+			return;
+
+		size_t word = index / 64;
+		if (word >= mBits.size())
+			mBits.resize(word + 1, 0);
+
+		mBits[word] |= 1ULL << (index % 64);
+	}
+
+	bool test(int index) const
+	{
+		if (index < 0 || (size_t)(index / 64) >= mBits.size())
+			return false;
+
+		return (mBits[index / 64] & (1ULL << (index % 64))) != 0;
+	}
+
+	bool intersects(const GenreSet& other) const
+	{
+		size_t count = mBits.size() < other.mBits.size() ? mBits.size() : other.mBits.size();
+		for (size_t i = 0; i < count; i++)
+			if (mBits[i] & other.mBits[i])
+				return true;
+
+		return false;
+	}
+
+	bool any() const
+	{
+		for (auto bits : mBits)
+			if (bits != 0)
+				return true;
+
+		return false;
+	}
+
+	bool none() const { return !any(); }
+
+	void reset()
+	{
+		for (auto& bits : mBits)
+			bits = 0;
+	}
+
+private:
+	std::vector<unsigned long long> mBits;
+};
+
+// Kept by the MetaDataList while its version is unchanged
+struct GenreCache
+{
+	GenreCache() : valid(false), version(0) { }
+
+	bool valid;
+	unsigned int version;
+	GenreSet genres;
+};
+
 struct GameGenre
 {
 	GameGenre()
 	{
 		id = 0;
+		index = -1;
 		parentId = 0;
 		parent = nullptr;
 	}
 
 	int id;
+	int index; // Position in Genres::getGameGenres
 	int parentId;
 
 	std::string nom_en;
@@ -56,14 +125,17 @@ public:
 
 	static GameGenre* getGameGenre(const std::string& id);
 
+	static const GenreSet& getGenreSet(MetaDataList* game);
+	static GenreSet getGenreSet(const std::unordered_set<std::string>& ids);
+
 	static std::string					genreStringFromIds(const std::vector<std::string>& ids, bool localized = true);
 
 	static std::vector<std::string>		getGenreFiltersNames(MetaDataList* game);
 
 private:
 	static std::vector<GameGenre*> mGameGenres;
-	static std::map<int, GameGenre*> mGenres;
-	static std::map<std::string, int> mAllGenresNames;
+	static std::unordered_map<int, GameGenre*> mGenres;
+	static std::unordered_map<std::string, int> mAllGenresNames;
 };
 
 #endif // ES_CORE_GENRES_H
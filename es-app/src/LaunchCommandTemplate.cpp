@@ -0,0 +1,108 @@
+#include "LaunchCommandTemplate.h"
+
+#include "utils/StringUtil.h"
+#include "SystemData.h"
+#include "Paths.h"
+#include <string.h>
+
+std::string LaunchCommandTemplate::formatArgument(const std::string& name)
+{
+	if (name.find(" ") != std::string::npos)
+		return "\"" + Utils::String::replace(name, "\"", "\\\"") + "\"";
+
+	return Utils::String::replace(name, "\"", "\\\"");
+}
+
+LaunchCommandTemplate::LaunchCommandTemplate(const std::string& command, SystemData* system, const std::string& emulator, const std::string& core) : mTokens(0), mLiteralLength(0)
+{
+	const char* tokenNames[] = { "ROM", "BASENAME", "ROM_RAW", "GAMENAME", "GAMEINFOXML", "CONTROLLERSCONFIG" };
+
+	std::string staticNames[] = { "SYSTEM", "EMULATOR", "CORE", "HOME", "SYSTEMNAME" };
+	std::string staticValues[] = { system->getName(), emulator, core, Paths::getHomePath(), formatArgument(system->getFullName()) };
+
+	size_t start = 0;
+	size_t pos = 0;
+
+	while ((pos = command.find('%', pos)) != std::string::npos)
+	{
+		size_t end = command.find('%', pos + 1);
+		if (end == std::string::npos)
+			break;
+
+		std::string name = command.substr(pos + 1, end - pos - 1);
+
+		int token = -1;
+		for (int i = 0; i < TOKEN_COUNT; i++)
+		{
+			if (name == tokenNames[i])
+			{
+				token = i;
+				break;
+			}
+		}
+
+		int staticToken = -1;
+		if (token < 0)
+		{
+			for (int i = 0; i < (int)(sizeof(staticNames) / sizeof(staticNames[0])); i++)
+			{
+				if (name == staticNames[i])
+				{
+					staticToken = i;
+					break;
+				}
+			}
+		}
+
+		// Not a known token : the % is part of the text
+		if (token < 0 && staticToken < 0)
+		{
+			pos++;
+			continue;
+		}
+
+		addLiteral(command.c_str() + start, pos - start);
+
+		if (staticToken >= 0)
+			addLiteral(staticValues[staticToken].c_str(), staticValues[staticToken].size());
+		else
+		{
+			mParts.push_back(Part { token, "" });
+			mTokens |= 1 << token;
+		}
+
+		pos = end + 1;
+		start = pos;
+	}
+
+	addLiteral(command.c_str() + start, command.size() - start);
+}
+
+void LaunchCommandTemplate::addLiteral(const char* text, size_t length)
+{
+	if (length == 0)
+		return;
+
+	mLiteralLength += length;
+
+	if (!mParts.empty() && mParts.back().token < 0)
+		mParts.back().text.append(text, length);
+	else
+		mParts.push_back(Part { -1, std::string(text, length) });
+}
+
+std::string LaunchCommandTemplate::format(const std::string* values) const
+{
+	size_t length = mLiteralLength;
+	for (auto& part : mParts)
+		if (part.token >= 0)
+			length += values[part.token].size();
+
+	std::string ret;
+	ret.reserve(length);
+
+	for (auto& part : mParts)
+		ret += part.token < 0 ? part.text : values[part.token];
+
+	return ret;
+}
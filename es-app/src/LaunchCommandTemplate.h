@@ -0,0 +1,52 @@
+#pragma once
+#ifndef ES_APP_LAUNCH_COMMAND_TEMPLATE_H
+#define ES_APP_LAUNCH_COMMAND_TEMPLATE_H
+
+#include <string>
+#include <vector>
+
+class SystemData;
+
+// Launch command of a system/emulator/core, split once into literal parts & game tokens.
+// The tokens that only depend on the system, the emulator & the core (%SYSTEM%, %EMULATOR%, %CORE%, %HOME%, %SYSTEMNAME%) are resolved when it's compiled.
+// The other % words are kept as is, like %NETPLAY% which is handled on the final command.
+class LaunchCommandTemplate
+{
+public:
+	enum Token
+	{
+		ROM = 0,
+		BASENAME = 1,
+		ROM_RAW = 2,
+		GAMENAME = 3,
+		GAMEINFOXML = 4,
+		CONTROLLERSCONFIG = 5,
+
+		TOKEN_COUNT = 6
+	};
+
+	LaunchCommandTemplate(const std::string& command, SystemData* system, const std::string& emulator, const std::string& core);
+
+	bool hasToken(Token token) const { return (mTokens & (1 << token)) != 0; }
+
+	// values is indexed by Token
+	std::string format(const std::string* values) const;
+
+	// Quoted if it contains spaces
+	static std::string formatArgument(const std::string& name);
+
+private:
+	void addLiteral(const char* text, size_t length);
+
+	struct Part
+	{
+		int			token; // -1 for a literal
+		std::string text;
+	};
+
+	std::vector<Part> mParts;
+	unsigned int	  mTokens;
+	size_t			  mLiteralLength;
+};
+
+#endif // ES_APP_LAUNCH_COMMAND_TEMPLATE_H
@@ -8,6 +8,8 @@
 #include "LocaleES.h"
 #include "Settings.h"
 #include "FileData.h"
+#include "FileDataPool.h"
+#include "Genres.h"
 #include "ImageIO.h"
 
 std::vector<MetaDataDecl> MetaDataList::mMetaDataDecls;
@@ -144,14 +146,102 @@ MetaDataId MetaDataList::getId(const std::string& key) const
 	return mGameIdMap[key];
 }
 
-MetaDataList::MetaDataList(MetaDataListType type) : mType(type), mWasChanged(false), mRelativeTo(nullptr)
+MetaDataList::MetaDataList(MetaDataListType type) : mType(type), mWasChanged(false), mVersion(0), mRelativeTo(nullptr), mOwner(nullptr), mGenreCache(nullptr)
 {
 	memset(mIndices, -1, sizeof(mIndices));
 }
 
+MetaDataList::MetaDataList(const MetaDataList& source) : 
+	mScrapeDates(source.mScrapeDates), mName(source.mName), mType(source.mType), mWasChanged(source.mWasChanged), mVersion(source.mVersion), mRelativeTo(source.mRelativeTo), mOwner(nullptr), mGenreCache(nullptr),
+	mValues(source.mValues), mUnKnownElements(source.mUnKnownElements)
+{
+	memcpy(mIndices, source.mIndices, sizeof(mIndices));
+}
+
+MetaDataList::~MetaDataList()
+{
+	if (mGenreCache != nullptr)
+		delete mGenreCache;
+}
+
+GenreCache* MetaDataList::getGenreCache()
+{
+	if (mGenreCache == nullptr)
+		mGenreCache = new GenreCache();
+
+	return mGenreCache;
+}
+
+void* MetaDataList::operator new(size_t size)
+{
+	return FileDataPool::allocate(size);
+}
+
+void MetaDataList::operator delete(void* ptr, size_t size)
+{
+	FileDataPool::deallocate(ptr, size);
+}
+
+// Notifies the systems before & after a statistic of the owner changes, so the game counts are updated without a full scan
+class StatisticsChangeScope
+{
+public:
+	StatisticsChangeScope(FileData* owner)
+	{
+		if (owner != nullptr)
+			SystemData::beginGameStatisticsChange(owner, mChanges);
+	}
+
+	~StatisticsChangeScope()
+	{
+		if (!mChanges.empty())
+			SystemData::endGameStatisticsChange(mChanges);
+	}
+
+private:
+	std::vector<GameStatisticsChange> mChanges;
+};
+
+MetaDataList& MetaDataList::operator=(const MetaDataList& source)
+{
+	if (this == &source)
+		return *this;
+
+	// Keep the owner : the list still belongs to the same file
+	StatisticsChangeScope scope(mOwner);
+
+	mScrapeDates = source.mScrapeDates;
+	mName = source.mName;
+	mType = source.mType;
+	mWasChanged = source.mWasChanged;
+	mVersion++;
+	mRelativeTo = source.mRelativeTo;
+	memcpy(mIndices, source.mIndices, sizeof(mIndices));
+	mValues = source.mValues;
+	mUnKnownElements = source.mUnKnownElements;
+	return *this;
+}
+
+bool MetaDataList::isCountedStatistic(MetaDataId id)
+{
+	switch (id)
+	{
+	case MetaDataId::Favorite:
+	case MetaDataId::Hidden:
+	case MetaDataId::KidGame:
+	case MetaDataId::PlayCount:
+	case MetaDataId::GameTime:
+	case MetaDataId::LastPlayed:
+		return true;
+	default:
+		return false;
+	}
+}
+
 void MetaDataList::loadFromXML(MetaDataListType type, pugi::xml_node& node, SystemData* system)
 {
 	mType = type;
+	mVersion++;
 	mRelativeTo = system;	
 
 	mUnKnownElements.clear();
@@ -364,6 +454,7 @@ void MetaDataList::set(MetaDataId id, const std::string& value)
 
 		mName = value;
 		mWasChanged = true;
+		mVersion++;
 		return;
 	}
 
@@ -373,6 +464,9 @@ void MetaDataList::set(MetaDataId id, const std::string& value)
 	// if (prev != mMap.cend() && prev->second == value)
 		return;
 
+	StatisticsChangeScope scope(mOwner != nullptr && isCountedStatistic(id) ? mOwner : nullptr);
+	mVersion++;
+
 	#define IS_TRIMCHAR(c) (c == ' ' || c == '\t' || c == '\r' || c == '\n')
 
 	if (mGameTypeMap[id] == MD_PATH && mRelativeTo != nullptr) // if it's a path, resolve relative paths	
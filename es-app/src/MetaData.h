@@ -12,6 +12,7 @@
 class SystemData;
 class FileData;
 class Scraper;
+struct GenreCache;
 
 namespace pugi { class xml_node; }
 
@@ -145,6 +146,13 @@ public:
 	void migrate(FileData* file, pugi::xml_node& node);
 
 	MetaDataList(MetaDataListType type);
+	MetaDataList(const MetaDataList& source);
+	MetaDataList& operator=(const MetaDataList& source);
+	~MetaDataList();
+
+	// Allocated with the FileData owning them, see FileDataPool
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr, size_t size);
 	
 	void set(MetaDataId id, const std::string& value);
 
@@ -163,6 +171,12 @@ public:
 
 	bool wasChanged() const;
 	void resetChangedFlag();
+
+	// Incremented on each change, to invalidate the values computed from the metadata
+	inline unsigned int getVersion() const { return mVersion; }
+
+	// Created on first use, see Genres::getGenreSet
+	GenreCache* getGenreCache();
 	const void setDirty() 
 	{ 
 		mWasChanged = true; 
@@ -181,6 +195,12 @@ public:
 	void setScrapeDate(const std::string& scraper);
 	Utils::Time::DateTime* getScrapeDate(const std::string& scraper);
 
+	// The file owning the list is notified when one of its statistics changes. Copies have no owner.
+	void setOwner(FileData* owner) { mOwner = owner; }
+
+	// Statistics aggregated by SystemData::getGameCountInfo
+	static bool isCountedStatistic(MetaDataId id);
+
 private:
 	std::map<int, Utils::Time::DateTime> mScrapeDates;
 
@@ -188,7 +208,10 @@ private:
 	MetaDataListType mType;
 //	std::map<MetaDataId, std::string> mMap;
 	bool mWasChanged;
+	unsigned int mVersion;
 	SystemData*		mRelativeTo;
+	FileData*		mOwner;
+	GenreCache*		mGenreCache;
 	
 	int8_t mIndices[MetaDataIdCount];
 	std::vector<std::string> mValues;
@@ -4,6 +4,8 @@
 #include "utils/FileSystemUtil.h"
 #include "utils/ThreadPool.h"
 #include "CollectionSystemManager.h"
+#include "FileDataPool.h"
+#include "LaunchCommandTemplate.h"
 #include "FileFilterIndex.h"
 #include "FileSorts.h"
 #include "Gamelist.h"
@@ -82,6 +84,7 @@ SystemData::SystemData(const SystemMetadata& meta, SystemEnvironmentData* envDat
 	mGridSizeOverride = Vector2f(0, 0);
 
 	mFilterIndex = nullptr;
+	mFileDataPool = nullptr;
 
 	if (pEmulators != nullptr)
 		mEmulators = *pEmulators;
@@ -94,6 +97,9 @@ SystemData::SystemData(const SystemMetadata& meta, SystemEnvironmentData* envDat
 	// if it's an actual system, initialize it, if not, just create the data structure
 	if (!mIsCollectionSystem && mIsGameSystem)
 	{
+		mFileDataPool = new FileDataPool();
+		FileDataPool::Scope poolScope(mFileDataPool);
+
 		mRootFolder = new FolderData(mEnvData->mStartPath, this);
 		mRootFolder->getMetadata().set(MetaDataId::Name, mMetadata.fullName);
 
@@ -154,20 +160,33 @@ SystemData::~SystemData()
 	if (mBindableRandom)
 		delete mBindableRandom;
 
+	// Dropped first : the games don't need to be unindexed one by one
+	if (mFilterIndex != nullptr)
+	{
+		delete mFilterIndex;
+		mFilterIndex = nullptr;
+	}
+
+	if (mGameCountInfo != nullptr)
+	{
+		delete mGameCountInfo;
+		mGameCountInfo = nullptr;
+	}
+
 	if (mRootFolder)
 		delete mRootFolder;
 
+	if (mFileDataPool != nullptr)
+		mFileDataPool->release();
+
 	if (!mIsCollectionSystem && mEnvData != nullptr)
 		delete mEnvData;
 
 	if (mSaveRepository != nullptr)
 		delete mSaveRepository;
 
-	if (mGameCountInfo != nullptr)
-		delete mGameCountInfo;
-
-	if (mFilterIndex != nullptr)
-		delete mFilterIndex;
+	for (auto tpl : mLaunchCommandTemplates)
+		delete tpl.second;
 }
 
 void SystemData::removeMultiDiskContent(std::unordered_map<std::string, FileData*>& fileMap)
@@ -994,6 +1013,8 @@ bool SystemData::loadConfig(Window* window)
 		CollectionSystemManager::get()->loadCollectionSystems();
 	}
 
+	LOG(LogDebug) << "SystemData::loadConfig : " << FileDataPool::getStatistics();
+
 	if (SystemData::sSystemVector.size() > 0)
 	{
 		createGroupedSystems();
@@ -1284,6 +1305,8 @@ bool SystemData::hasDirtySystems()
 
 void SystemData::deleteSystems()
 {
+	StopWatch stopWatch("deleteSystems :", LogDebug);
+
 	bool saveOnExit = !Settings::IgnoreGamelist() && Settings::SaveGamelistsOnExit();
 
 	for (unsigned int i = 0; i < sSystemVector.size(); i++)
@@ -1299,6 +1322,8 @@ void SystemData::deleteSystems()
 
 	sSystemVector.clear();
 	IsManufacturerSupported = false;
+
+	FileDataPool::resetStatistics();
 }
 
 std::string SystemData::getConfigPath()
@@ -1464,76 +1489,126 @@ FileData* SystemData::getRandomGame()
 	return list.at(target);
 }
 
-GameCountInfo* SystemData::getGameCountInfo()
+static void readGameStatistics(FileData* game, GameStatistics& stats)
 {
-	if (mGameCountInfo != nullptr)
-		return mGameCountInfo;	
+	stats.favorite = game->getFavorite();
+	stats.hidden = game->getHidden();
+	stats.playCount = Utils::String::toInteger(game->getMetadata(MetaDataId::PlayCount));
+	stats.playTime = atol(game->getMetadata(MetaDataId::GameTime).c_str());
+	stats.lastPlayed = game->getMetadata(MetaDataId::LastPlayed);
+	stats.name = game->getName();
+}
 
-	std::vector<FileData*> games = mRootFolder->getFilesRecursive(GAME, true);
+// Returns false when a maximum was removed : only a full scan can find the next one
+static bool updateGameCountInfo(GameCountInfo* info, const GameStatistics& removed, const GameStatistics& added)
+{
+	bool sameGameStillVisible = added.visible && added.name == removed.name;
 
-	int realTotal = games.size();
-	if (mFilterIndex != nullptr)
+	if (removed.counted)
+		info->totalGames--;
+
+	if (removed.visible)
 	{
-		auto savedFilter = mFilterIndex;
-		mFilterIndex = nullptr;
-		realTotal = mRootFolder->getFilesRecursive(GAME, true).size();
-		mFilterIndex = savedFilter;
-	}
+		info->visibleGames--;
 
+		if (removed.favorite)
+			info->favoriteCount--;
 
-	mGameCountInfo = new GameCountInfo();
-	mGameCountInfo->visibleGames = games.size();
-	mGameCountInfo->totalGames = realTotal;
-	mGameCountInfo->favoriteCount = 0;
-	mGameCountInfo->hiddenCount = 0;
-	mGameCountInfo->playCount = 0;
-	mGameCountInfo->gamesPlayed = 0;
-	mGameCountInfo->playTime = 0;
-	
-	int mostPlayCount = 0;
-	long gameTime = 0;
-	std::string mostCountPlayed;
+		if (removed.hidden)
+			info->hiddenCount--;
 
-	for (auto game : games)
+		if (removed.playCount > 0)
+		{
+			info->gamesPlayed--;
+			info->playCount -= removed.playCount;
+
+			if (removed.playCount == info->mostPlayCount && removed.name == info->mostPlayedByCount && !(sameGameStillVisible && added.playCount >= removed.playCount))
+				return false;
+		}
+
+		if (removed.playTime > 0)
+		{
+			info->playTime -= removed.playTime;
+
+			if (removed.playTime == info->mostPlayTime && removed.name == info->mostPlayedByTime && !(sameGameStillVisible && added.playTime >= removed.playTime))
+				return false;
+		}
+
+		if (!removed.lastPlayed.empty() && removed.lastPlayed == info->lastPlayedDate && !(added.visible && added.lastPlayed >= removed.lastPlayed))
+			return false;
+	}
+
+	if (added.counted)
+		info->totalGames++;
+
+	if (added.visible)
 	{
-		if (game->getFavorite())
-			mGameCountInfo->favoriteCount++;
+		info->visibleGames++;
+
+		if (added.favorite)
+			info->favoriteCount++;
 
-		if (game->getHidden())
-			mGameCountInfo->hiddenCount++;
+		if (added.hidden)
+			info->hiddenCount++;
 
-		int playCount = Utils::String::toInteger(game->getMetadata(MetaDataId::PlayCount));
-		if (playCount > 0)
+		if (added.playCount > 0)
 		{
-			mGameCountInfo->gamesPlayed++;
-			mGameCountInfo->playCount += playCount;
-			
-			if (playCount > mostPlayCount)
+			info->gamesPlayed++;
+			info->playCount += added.playCount;
+
+			if (added.playCount > info->mostPlayCount)
 			{
-				mostCountPlayed = game->getName();
-				mostPlayCount = playCount;
+				info->mostPlayedByCount = added.name;
+				info->mostPlayCount = added.playCount;
 			}
 		}
 
-		long seconds = atol(game->getMetadata(MetaDataId::GameTime).c_str());
-		if (seconds > 0)
+		if (added.playTime > 0)
 		{
-			mGameCountInfo->playTime += seconds;
-			
-			if (seconds > gameTime)
+			info->playTime += added.playTime;
+
+			if (added.playTime > info->mostPlayTime)
 			{
-				mGameCountInfo->mostPlayed = game->getName();
-				gameTime = seconds;
+				info->mostPlayedByTime = added.name;
+				info->mostPlayTime = added.playTime;
 			}
 		}
 
-		auto lastPlayed = game->getMetadata(MetaDataId::LastPlayed);
-		if (!lastPlayed.empty() && lastPlayed > mGameCountInfo->lastPlayedDate)
-			mGameCountInfo->lastPlayedDate = lastPlayed;
+		if (!added.lastPlayed.empty() && added.lastPlayed > info->lastPlayedDate)
+			info->lastPlayedDate = added.lastPlayed;
 	}
 
-	if (mGameCountInfo->mostPlayed.empty() && !mostCountPlayed.empty())
-		mGameCountInfo->mostPlayed = mostCountPlayed;
+	info->mostPlayed = info->mostPlayedByTime.empty() ? info->mostPlayedByCount : info->mostPlayedByTime;
+	return true;
+}
+
+GameCountInfo* SystemData::getGameCountInfo()
+{
+	if (mGameCountInfo != nullptr)
+		return mGameCountInfo;	
+
+	// A single pass : the filters are checked game by game
+	auto savedFilter = mFilterIndex;
+	mFilterIndex = nullptr;
+	std::vector<FileData*> games = mRootFolder->getFilesRecursive(GAME, true);
+	mFilterIndex = savedFilter;
+
+	bool filtered = mFilterIndex != nullptr && mFilterIndex->isFiltered();
+
+	mGameCountInfo = new GameCountInfo();
+
+	GameStatistics none;
+
+	for (auto game : games)
+	{
+		GameStatistics stats;
+		stats.counted = true;
+		stats.visible = !filtered || mFilterIndex->showFile(game);
+		if (stats.visible)
+			readGameStatistics(game, stats);
+
+		updateGameCountInfo(mGameCountInfo, none, stats);
+	}
 
 	return mGameCountInfo;
 	/*
@@ -1545,6 +1620,109 @@ GameCountInfo* SystemData::getGameCountInfo()
 	return mGameCount;*/
 }
 
+static void getGameStatistics(SystemData* system, FileData* game, GameStatistics& stats)
+{
+	if (game == nullptr || game->getType() != GAME)
+		return;
+
+	// Only the games of the system tree are counted
+	FolderData* root = system->getRootFolder();
+
+	FolderData* parent = game->getParent();
+	while (parent != nullptr && parent != root)
+		parent = parent->getParent();
+
+	if (parent == nullptr)
+		return;
+
+	GetFileContext ctx = root->getFileContext();
+	if (!FolderData::isFileDisplayed(game, &ctx, nullptr))
+		return;
+
+	stats.counted = true;
+
+	FileFilterIndex* index = system->getIndex(false);
+	stats.visible = index == nullptr || !index->isFiltered() || index->showFile(game);
+	if (stats.visible)
+		readGameStatistics(game, stats);
+}
+
+void SystemData::addToGameCountInfo(FileData* game)
+{
+	if (mGameCountInfo == nullptr)
+		return;
+
+	GameStatistics stats;
+	getGameStatistics(this, game, stats);
+
+	if (!updateGameCountInfo(mGameCountInfo, GameStatistics(), stats))
+		updateDisplayedGameCount();
+}
+
+void SystemData::removeFromGameCountInfo(FileData* game)
+{
+	if (mGameCountInfo == nullptr)
+		return;
+
+	GameStatistics stats;
+	getGameStatistics(this, game, stats);
+
+	if (!updateGameCountInfo(mGameCountInfo, stats, GameStatistics()))
+		updateDisplayedGameCount();
+}
+
+void SystemData::beginGameStatisticsChange(FileData* game, std::vector<GameStatisticsChange>& changes)
+{
+	if (game->getType() != GAME)
+		return;
+
+	FileData* sourceGame = game->getSourceFileData();
+	SystemData* sourceSystem = sourceGame->getSystem();
+
+	std::vector<std::pair<SystemData*, FileData*>> entries;
+
+	if (sourceSystem != nullptr && sourceSystem->mGameCountInfo != nullptr)
+		entries.push_back(std::make_pair(sourceSystem, sourceGame));
+
+	// Collections & groups hold their own entries for the game
+	for (auto system : sSystemVector)
+	{
+		if (system == sourceSystem || system->mGameCountInfo == nullptr || (!system->isCollection() && !system->isGroupSystem()))
+			continue;
+
+		FileData* entry = system->getRootFolder()->FindByPath(sourceGame->getPath());
+		if (entry != nullptr && entry->getSourceFileData() == sourceGame)
+			entries.push_back(std::make_pair(system, entry));
+	}
+
+	for (auto entry : entries)
+	{
+		GameStatisticsChange item;
+		item.system = entry.first;
+		item.entry = entry.second;
+		getGameStatistics(item.system, item.entry, item.before);
+		changes.push_back(item);
+	}
+}
+
+void SystemData::endGameStatisticsChange(std::vector<GameStatisticsChange>& changes)
+{
+	// Apply the difference between the values read before the change & the new ones
+	for (auto& item : changes)
+	{
+		if (item.system->mGameCountInfo == nullptr)
+			continue;
+
+		GameStatistics after;
+		getGameStatistics(item.system, item.entry, after);
+
+		if (!updateGameCountInfo(item.system->mGameCountInfo, item.before, after))
+			item.system->updateDisplayedGameCount();
+	}
+
+	changes.clear();
+}
+
 void SystemData::updateDisplayedGameCount()
 {
 	if (mGameCountInfo != nullptr)
@@ -1943,7 +2121,7 @@ std::string SystemData::getDefaultCore(const std::string emulatorName)
 
 std::string SystemData::getLaunchCommand(const std::string emulatorName, const std::string coreName)
 {
-	for (auto emulator : mEmulators)
+	for (auto& emulator : mEmulators)
 	{
 		if (emulator.name == emulatorName)
 		{
@@ -1959,6 +2137,30 @@ std::string SystemData::getLaunchCommand(const std::string emulatorName, const s
 	return getSystemEnvData()->mLaunchCommand;
 }
 
+const LaunchCommandTemplate* SystemData::getLaunchCommandTemplate(const std::string& emulatorName, const std::string& coreName, bool forceCore)
+{
+	std::string key = emulatorName + "/" + coreName + (forceCore ? "/force" : "");
+
+	auto it = mLaunchCommandTemplates.find(key);
+	if (it != mLaunchCommandTemplates.cend())
+		return it->second;
+
+	std::string command = getLaunchCommand(emulatorName, coreName);
+
+	if (forceCore)
+	{
+		if (command.find("%EMULATOR%") == std::string::npos && command.find("-emulator") == std::string::npos)
+			command = command + " -emulator %EMULATOR%";
+
+		if (command.find("%CORE%") == std::string::npos && command.find("-core") == std::string::npos)
+			command = command + " -core %CORE%";
+	}
+
+	auto tpl = new LaunchCommandTemplate(command, this, emulatorName, coreName);
+	mLaunchCommandTemplates[key] = tpl;
+	return tpl;
+}
+
 std::vector<std::string> SystemData::getCoreNames(std::string emulatorName)
 {
 	std::vector<std::string> list;
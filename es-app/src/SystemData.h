@@ -21,9 +21,12 @@
 
 class FileData;
 class FolderData;
+class FileDataPool;
+class LaunchCommandTemplate;
 class ThemeData;
 class Window;
 class SaveStateRepository;
+class SystemData;
 
 struct GameCountInfo
 {
@@ -36,6 +39,36 @@ struct GameCountInfo
 	long playTime;
 	std::string mostPlayed;
 	std::string lastPlayedDate;
+
+	// Maximums, to maintain mostPlayed incrementally
+	int mostPlayCount;
+	long mostPlayTime;
+	std::string mostPlayedByCount;
+	std::string mostPlayedByTime;
+};
+
+// Contribution of a game to the GameCountInfo of a system
+struct GameStatistics
+{
+	GameStatistics() : counted(false), visible(false), favorite(false), hidden(false), playCount(0), playTime(0) { }
+
+	bool counted; // displayed, filters ignored
+	bool visible; // displayed with the current filters
+
+	bool favorite;
+	bool hidden;
+	int playCount;
+	long playTime;
+	std::string lastPlayed;
+	std::string name;
+};
+
+// Statistics of a game entry read before they change, to apply the difference once they have changed
+struct GameStatisticsChange
+{
+	SystemData* system;
+	FileData* entry;
+	GameStatistics before;
 };
 
 struct SystemMetadata
@@ -113,6 +146,14 @@ public:
 	GameCountInfo* getGameCountInfo();
 	void updateDisplayedGameCount();
 
+	// Keep the game counts up to date when a game is added or removed, without scanning the games
+	void addToGameCountInfo(FileData* game);
+	void removeFromGameCountInfo(FileData* game);
+
+	// Called by MetaDataList before & after a counted statistic of a game changes, the caller keeps the changes
+	static void beginGameStatisticsChange(FileData* game, std::vector<GameStatisticsChange>& changes);
+	static void endGameStatisticsChange(std::vector<GameStatisticsChange>& changes);
+
 	static bool IsManufacturerSupported;
 	static bool hasDirtySystems();
 	static void deleteSystems();
@@ -197,6 +238,9 @@ public:
 	std::string getDefaultCore(const std::string emulatorName = "");
 
 	std::string getLaunchCommand(const std::string emulatorName, const std::string coreName);
+
+	// Compiled once per emulator/core. forceCore adds the -emulator & -core arguments if the command has none.
+	const LaunchCommandTemplate* getLaunchCommandTemplate(const std::string& emulatorName, const std::string& coreName, bool forceCore = false);
 	std::vector<std::string> getCoreNames(std::string emulatorName);
 
 	bool isCurrentFeatureSupported(EmulatorFeatures::Features feature);
@@ -275,6 +319,9 @@ private:
 
 	GameCountInfo* mGameCountInfo;
 	SaveStateRepository* mSaveRepository;
+	FileDataPool* mFileDataPool;
+
+	std::map<std::string, LaunchCommandTemplate*> mLaunchCommandTemplates;
 
 	bool mHidden;
 };
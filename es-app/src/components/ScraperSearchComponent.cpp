@@ -10,6 +10,7 @@
 #include "guis/GuiTextEditPopup.h"
 #include "guis/GuiTextEditPopupKeyboard.h"
 #include "resources/Font.h"
+#include "scrapers/ScraperRateLimiter.h"
 #include "utils/StringUtil.h"
 #include "FileData.h"
 #include "Log.h"
@@ -260,6 +261,9 @@ private:
 
 void ScraperSearchComponent::search(const ScraperSearchParams& params)
 {
+	// The user asks for this scrape : try again even if the quota was spent
+	ScraperRateLimiter::clearQuotaExhausted();
+
 	if (mSearchStartingCallback)
 		mSearchStartingCallback();
 
@@ -1129,6 +1129,13 @@ void GuiMenu::openDeveloperSettings()
 	s->addWithLabel(_("OPTIMIZE VIDEO VRAM USAGE"), optimizeVideo);
 	s->addSaveFunc([optimizeVideo] { Settings::getInstance()->setBool("OptimizeVideo", optimizeVideo->getState()); });
 
+	s->addSwitch(_("PACK SMALL IMAGES IN A TEXTURE ATLAS"), _("Icons share textures, reducing texture switches when drawing menus"), "TextureAtlas", true, nullptr);
+	s->addSwitch(_("SKIP RENDERING UNCHANGED FRAMES"), _("Stops redrawing the screen while nothing moves, to save power"), "SkipUnchangedFrames", true, nullptr);
+	s->addSwitch(_("DISTANCE FIELD TEXT RENDERING"), _("All font sizes share one glyph atlas and scaled text stays sharp. Needs a shader-based renderer"), "FontDistanceField", true, nullptr);
+	s->addSwitch(_("DECODE VIDEOS TO YUV"), _("Video frames are converted to RGB by the GPU instead of the CPU. Needs a shader-based renderer"), "VideoYUV", true, nullptr);
+	s->addSwitch(_("PLAY LOW RESOLUTION VIDEO PROXIES"), _("Videos are transcoded in the background to the size of the theme's video boxes"), "VideoProxies", true, nullptr);
+	s->addSwitch(_("PRE-ROLL NEIGHBOUR VIDEOS"), _("The videos of the next & previous games are opened in advance, paused on their first frame"), "VideoPreroll", true, nullptr);
+
 	s->addSwitch(_("USE FILESYSTEM CACHE"), "UseFileCache", true, [s] { Utils::FileSystem::FileSystemCache::reset(); });
 
 	s->onFinalize([s, window]
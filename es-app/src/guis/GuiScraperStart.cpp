@@ -6,6 +6,8 @@
 #include "FileData.h"
 #include "SystemData.h"
 #include "scrapers/ThreadedScraper.h"
+#include "scrapers/ScrapeJournal.h"
+#include "scrapers/ScraperRateLimiter.h"
 #include "LocaleES.h"
 #include "GuiLoading.h"
 #include "views/gamelist/IGameListView.h"
@@ -58,6 +60,13 @@ void GuiScraperStart::loadScrapPage()
 
 	std::string scraperName = Settings::getInstance()->getString("Scraper");
 
+	int pendingGames = ThreadedScraper::isRunning() ? 0 : ScrapeJournal::getPendingCount();
+	if (pendingGames > 0)
+	{
+		addGroup(_("INTERRUPTED SCRAPE"));
+		addEntry(Utils::String::format(_("RESUME (%d GAMES LEFT)").c_str(), pendingGames), false, std::bind(&GuiScraperStart::resume, this));
+	}
+
 	// scrape from
 	auto scraper_list = std::make_shared< OptionListComponent< std::string > >(mWindow, _("SCRAPING DATABASE"), false);
 
@@ -140,7 +149,12 @@ void GuiScraperStart::loadScrapPage()
 	mMenu.clearButtons();
 	mMenu.addButton(_("SCRAPE NOW"), _("START"), std::bind(&GuiScraperStart::pressedStart, this));
 
-	scraper_list->setSelectedChangedCallback([this, scraperName, scraper_list](std::string value) { Settings::getInstance()->setString("Scraper", value); });
+	scraper_list->setSelectedChangedCallback([this, scraperName, scraper_list](std::string value)
+	{
+		// The spent quota was the one of the previous scraper
+		if (Settings::getInstance()->setString("Scraper", value))
+			ScraperRateLimiter::clearQuotaExhausted();
+	});
 }
 
 void GuiScraperStart::loadSettingsPage() 
@@ -274,6 +288,7 @@ void GuiScraperStart::loadSettingsPage()
 	addSwitch(_("OVERWRITE NAMES"), "ScrapeNames", true);
 	addSwitch(_("OVERWRITE DESCRIPTIONS"), "ScrapeDescription", true);
 	addSwitch(_("OVERWRITE MEDIAS"), "ScrapeOverWrite", true);
+	addSwitch(_("REUSE CACHED SCRAPER RESPONSES"), "ScrapeCache", true);
 
 	addGroup(_("SCRAPE FOR"));
 
@@ -399,6 +414,33 @@ void GuiScraperStart::start()
 		}));
 }
 
+void GuiScraperStart::resume()
+{
+	auto scraperName = std::make_shared<std::string>();
+
+	mWindow->pushGui(new GuiLoading<std::queue<ScraperSearchParams>>(mWindow, _("PLEASE WAIT"),
+		[scraperName](IGuiLoadingHandler* gui)
+		{
+			return ScrapeJournal::load(*scraperName);
+		},
+		[this, scraperName](std::queue<ScraperSearchParams> searches)
+		{
+			if (searches.empty())
+			{
+				ScrapeJournal::remove();
+				mWindow->pushGui(new GuiMsgBox(mWindow, _("NO GAMES FIT THAT CRITERIA.")));
+				return;
+			}
+
+			// Continue with the scraper the scrape was started with
+			if (!scraperName->empty() && Scraper::getScraper(*scraperName) != nullptr)
+				Settings::getInstance()->setString("Scraper", *scraperName);
+
+			ThreadedScraper::start(mWindow, searches);
+			close();
+		}));
+}
+
 std::queue<ScraperSearchParams> GuiScraperStart::getSearches(std::vector<SystemData*> systems, FilterFunc mediaSelector, FilterFunc dateSelector, IGuiLoadingHandler* handler)
 {
 	std::queue<ScraperSearchParams> queue;
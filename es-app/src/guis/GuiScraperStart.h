@@ -29,6 +29,7 @@ public:
 private:	
 	void pressedStart();
 	void start();
+	void resume();
 	
 	void loadActivePage();
 
@@ -28,6 +28,7 @@
 #include "AudioManager.h"
 #include "NetworkThread.h"
 #include "scrapers/ThreadedScraper.h"
+#include "scrapers/ScraperMediaProcessor.h"
 #include "ThreadedHasher.h"
 #include <FreeImage.h>
 #include "ImageIO.h"
@@ -541,6 +542,7 @@ int main(int argc, char* argv[])
 	ViewController::init(&window);
 
 	window.setReloadGamelistsCallback([&window] { ViewController::reloadAllGames(&window, true, true); });	
+	HttpReq::setUiThreadDispatcher([&window](const std::function<void()>& func) { window.postToUiThread(func); });
 	window.pushGui(ViewController::get());
 	if (!window.init(true, false))
 	{
@@ -786,6 +788,16 @@ int main(int argc, char* argv[])
 		TRYCATCH("Window.update" ,window.update(deltaTime))	
 		TRYCATCH("Window.render", window.render())
 
+		if (window.isFrameSkipped())
+		{
+			// Nothing was drawn : don't swap, just wait for the next frame
+			int processDuration = SDL_GetTicks() - curTime;
+			if (processDuration < 16)
+				SDL_Delay(16 - processDuration);
+
+			continue;
+		}
+
 		int fpsLimit = Settings::FpsLimit();
 		if (fpsLimit > 0)
 		{
@@ -808,6 +820,7 @@ int main(int argc, char* argv[])
 	WatchersManager::stop();
 	ThreadedHasher::stop();
 	ThreadedScraper::stop();
+	ScraperMediaProcessor::stop();
 
 	ApiSystem::getInstance()->deinit();
 
@@ -834,6 +847,8 @@ int main(int argc, char* argv[])
 
 	window.deinit();
 
+	HttpReq::shutdown();
+
 	Utils::Platform::processQuitMode();
 
 	LOG(LogInfo) << "EmulationStation cleanly shutting down.";
@@ -0,0 +1,284 @@
+#include "scrapers/ScrapeJournal.h"
+
+#include "scrapers/Scraper.h"
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+#include "FileData.h"
+#include "SystemData.h"
+#include "Paths.h"
+#include "Log.h"
+#include <map>
+#include <set>
+#include <string.h>
+#include <unordered_map>
+
+#define SCRAPE_JOURNAL_HEADER	"#ScrapeJournal"
+
+#define JOURNAL_PENDING	'P'
+#define JOURNAL_STARTED	'S'
+#define JOURNAL_DONE	'D'
+
+std::mutex		ScrapeJournal::sLock;
+FILE*			ScrapeJournal::sFile = nullptr;
+int				ScrapeJournal::sId = 0;
+
+static std::string getScrapeJournalPath()
+{
+	return Utils::FileSystem::getGenericPath(Paths::getUserEmulationStationPath() + "/tmp/scrapejournal.txt");
+}
+
+static FILE* openFile(const std::string& path, const char* mode)
+{
+#if defined(_WIN32)
+	return _wfopen(Utils::String::convertToWideString(path).c_str(), Utils::String::convertToWideString(mode).c_str());
+#else
+	return fopen(path.c_str(), mode);
+#endif
+}
+
+int ScrapeJournal::begin(const std::string& scraperName, std::queue<ScraperSearchParams> searches)
+{
+	std::unique_lock<std::mutex> lock(sLock);
+
+	if (sFile != nullptr)
+	{
+		fclose(sFile);
+		sFile = nullptr;
+	}
+
+	sId++;
+
+	std::string path = Utils::FileSystem::getParent(getScrapeJournalPath());
+	if (!Utils::FileSystem::exists(path))
+		Utils::FileSystem::createDirectory(path);
+
+	sFile = openFile(getScrapeJournalPath(), "wb");
+	if (sFile == nullptr)
+	{
+		LOG(LogWarning) << "ScrapeJournal : unable to write " << getScrapeJournalPath();
+		return sId;
+	}
+
+	fprintf(sFile, "%s\t%s\n", SCRAPE_JOURNAL_HEADER, scraperName.c_str());
+
+	while (!searches.empty())
+	{
+		auto& search = searches.front();
+		if (search.game != nullptr && search.system != nullptr)
+			fprintf(sFile, "%c\t%d\t%s\t%s\n", JOURNAL_PENDING, search.overWriteMedias ? 1 : 0, search.system->getName().c_str(), search.game->getPath().c_str());
+
+		searches.pop();
+	}
+
+	fflush(sFile);
+	return sId;
+}
+
+void ScrapeJournal::close(int id, bool completed)
+{
+	std::unique_lock<std::mutex> lock(sLock);
+
+	// A new scrape has started meanwhile
+	if (id != sId)
+		return;
+
+	if (sFile != nullptr)
+	{
+		fclose(sFile);
+		sFile = nullptr;
+	}
+
+	if (completed)
+		Utils::FileSystem::removeFile(getScrapeJournalPath());
+}
+
+void ScrapeJournal::write(char state, FileData* game)
+{
+	if (game == nullptr)
+		return;
+
+	std::unique_lock<std::mutex> lock(sLock);
+	if (sFile == nullptr)
+		return;
+
+	// Flushed on each line : the journal must survive a crash
+	fprintf(sFile, "%c\t%s\n", state, game->getPath().c_str());
+	fflush(sFile);
+}
+
+void ScrapeJournal::markStarted(FileData* game)
+{
+	write(JOURNAL_STARTED, game);
+}
+
+void ScrapeJournal::markDone(FileData* game)
+{
+	write(JOURNAL_DONE, game);
+}
+
+struct ScrapeJournalItem
+{
+	std::string system;
+	std::string path;
+	bool overWriteMedias;
+};
+
+static bool readJournal(std::string& scraperName, std::vector<ScrapeJournalItem>& items, std::set<std::string>& started, std::set<std::string>& done)
+{
+	std::string path = getScrapeJournalPath();
+	if (!Utils::FileSystem::exists(path))
+		return false;
+
+	std::string text = Utils::FileSystem::readAllText(path);
+
+	// The last line may be incomplete if ES was stopped while writing it
+	auto end = text.rfind('\n');
+	if (end == std::string::npos)
+		return false;
+
+	bool valid = false;
+
+	size_t pos = 0;
+	while (pos < end)
+	{
+		size_t next = text.find('\n', pos);
+		std::string line = text.substr(pos, next - pos);
+		pos = next + 1;
+
+		if (!valid)
+		{
+			if (!Utils::String::startsWith(line, SCRAPE_JOURNAL_HEADER "\t"))
+				return false;
+
+			scraperName = line.substr(strlen(SCRAPE_JOURNAL_HEADER) + 1);
+			valid = true;
+			continue;
+		}
+
+		if (line.size() < 3 || line[1] != '\t')
+			continue;
+
+		switch (line[0])
+		{
+		case JOURNAL_PENDING:
+			{
+				auto parts = Utils::String::split(line.substr(2), '\t');
+				if (parts.size() < 3)
+					continue;
+
+				ScrapeJournalItem item;
+				item.overWriteMedias = parts[0] == "1";
+				item.system = parts[1];
+				item.path = line.substr(2 + parts[0].size() + 1 + parts[1].size() + 1);
+				items.push_back(item);
+			}
+			break;
+
+		case JOURNAL_STARTED:
+			started.insert(line.substr(2));
+			break;
+
+		case JOURNAL_DONE:
+			done.insert(line.substr(2));
+			break;
+		}
+	}
+
+	return valid;
+}
+
+int ScrapeJournal::getPendingCount()
+{
+	std::unique_lock<std::mutex> lock(sLock);
+
+	std::string scraperName;
+	std::vector<ScrapeJournalItem> items;
+	std::set<std::string> started;
+	std::set<std::string> done;
+
+	if (!readJournal(scraperName, items, started, done))
+		return 0;
+
+	int count = 0;
+	for (auto& item : items)
+		if (done.find(item.path) == done.cend())
+			count++;
+
+	return count;
+}
+
+std::queue<ScraperSearchParams> ScrapeJournal::load(std::string& scraperName)
+{
+	std::vector<ScrapeJournalItem> items;
+	std::set<std::string> started;
+	std::set<std::string> done;
+
+	{
+		std::unique_lock<std::mutex> lock(sLock);
+		if (!readJournal(scraperName, items, started, done))
+			return std::queue<ScraperSearchParams>();
+	}
+
+	// Games by path, built once per system
+	std::map<std::string, std::unordered_map<std::string, FileData*>> games;
+
+	auto findGame = [&games](SystemData* system, const std::string& path) -> FileData*
+	{
+		auto it = games.find(system->getName());
+		if (it == games.cend())
+		{
+			auto& files = games[system->getName()];
+			for (auto file : system->getRootFolder()->getFilesRecursive(GAME))
+				files[file->getPath()] = file;
+
+			it = games.find(system->getName());
+		}
+
+		auto game = it->second.find(path);
+		return game == it->second.cend() ? nullptr : game->second;
+	};
+
+	std::queue<ScraperSearchParams> searches;
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (auto& item : items)
+		{
+			if (done.find(item.path) != done.cend())
+				continue;
+
+			bool wasStarted = started.find(item.path) != started.cend();
+			if (wasStarted != (pass == 0))
+				continue;
+
+			SystemData* system = SystemData::getSystem(item.system);
+			if (system == nullptr)
+				continue;
+
+			FileData* game = findGame(system, item.path);
+			if (game == nullptr)
+				continue;
+
+			ScraperSearchParams search;
+			search.system = system;
+			search.game = game;
+			search.overWriteMedias = item.overWriteMedias;
+			searches.push(search);
+		}
+	}
+
+	return searches;
+}
+
+void ScrapeJournal::remove()
+{
+	std::unique_lock<std::mutex> lock(sLock);
+
+	if (sFile != nullptr)
+	{
+		fclose(sFile);
+		sFile = nullptr;
+	}
+
+	Utils::FileSystem::removeFile(getScrapeJournalPath());
+}
@@ -0,0 +1,41 @@
+#pragma once
+#ifndef ES_APP_SCRAPERS_SCRAPE_JOURNAL_H
+#define ES_APP_SCRAPERS_SCRAPE_JOURNAL_H
+
+#include <mutex>
+#include <queue>
+#include <string>
+#include <stdio.h>
+
+struct ScraperSearchParams;
+class FileData;
+
+// On-disk log of a running scrape, in ~/.emulationstation/tmp/scrapejournal.txt, so a scrape interrupted by a restart,
+// a crash or an exhausted quota can be resumed where it stopped. The games to scrape are written when the scrape starts,
+// then one line is appended when a game starts & when it is done. The file is removed once the scrape completes.
+class ScrapeJournal
+{
+public:
+	// Returns the journal id, to give to close
+	static int begin(const std::string& scraperName, std::queue<ScraperSearchParams> searches);
+	static void close(int id, bool completed);
+
+	static void markStarted(FileData* game);
+	static void markDone(FileData* game);
+
+	// Number of games left by an interrupted scrape
+	static int getPendingCount();
+
+	// Games started but not done come first : their partial media downloads are resumed
+	static std::queue<ScraperSearchParams> load(std::string& scraperName);
+	static void remove();
+
+private:
+	static void write(char state, FileData* game);
+
+	static std::mutex	sLock;
+	static FILE*		sFile;
+	static int			sId;
+};
+
+#endif // ES_APP_SCRAPERS_SCRAPE_JOURNAL_H
@@ -16,9 +16,12 @@
 #include "HfsDBScraper.h"
 #include "IGDBScraper.h"
 #include "utils/Uri.h"
+#include "ScraperCache.h"
+#include "ScraperRateLimiter.h"
 
 #define OVERQUOTA_RETRY_DELAY 15000
 #define OVERQUOTA_RETRY_COUNT 5
+#define SCRAPER_REQUEST_POLL_DELAY 1000 // ms
 
 std::vector<std::pair<std::string, Scraper*>> Scraper::scrapers
 {
@@ -255,6 +258,20 @@ void ScraperSearchHandle::update()
 	}
 }
 
+// The UI thread notifies the completion of the requests. When it's busy (ex : a game is running), the request state is still read from time to time
+static bool isCompletionPending(bool completionNotified, bool requestCompleted, unsigned int& lastPollTime)
+{
+	if (!completionNotified || requestCompleted)
+		return false;
+
+	unsigned int now = SDL_GetTicks();
+	if (now - lastPollTime < SCRAPER_REQUEST_POLL_DELAY)
+		return true;
+
+	lastPollTime = now;
+	return false;
+}
+
 // ScraperHttpRequest
 ScraperHttpRequest::ScraperHttpRequest(std::vector<ScraperSearchResult>& resultsWrite, const std::string& url, HttpReqOptions* options)
 	: ScraperRequest(resultsWrite)
@@ -264,17 +281,116 @@ ScraperHttpRequest::ScraperHttpRequest(std::vector<ScraperSearchResult>& results
 	if (options != nullptr)
 		mOptions = *options;
 	
-	mRequest = new HttpReq(url, &mOptions);
+	mRequest = nullptr;
+	mCompletionNotified = false;
+	mRequestCompleted = false;
+	mLastPollTime = 0;
+	mIsCached = false;
+	mIsFetching = false;
+	mWaitingForFetch = false;
+	mWaitingForSlot = false;
+	mHasSlot = false;
+
 	mUrl = url;
 	mRetryCount = 0;
 	mOverQuotaPendingTime = 0;
 	mOverQuotaRetryDelay = OVERQUOTA_RETRY_DELAY;
 	mOverQuotaRetryCount = OVERQUOTA_RETRY_COUNT;
+
+	startRequest(url);
 }
 
 ScraperHttpRequest::~ScraperHttpRequest()
 {
-	delete mRequest;	
+	releaseSlot(0);
+	endFetch();
+
+	if (mRequest != nullptr)
+		delete mRequest;
+}
+
+void ScraperHttpRequest::startRequest(const std::string& url)
+{
+	releaseSlot(0);
+
+	if (mRequest != nullptr)
+	{
+		delete mRequest;
+		mRequest = nullptr;
+	}
+
+	mRequestUrl = url;
+	mRequestOptions = mOptions;
+	mIsCached = false;
+	mCachedContent.clear();
+
+	if (!ScraperCache::isEnabled())
+	{
+		sendRequest();
+		return;
+	}
+
+	mCacheKey = ScraperCache::getKey(url, mOptions);
+
+	ScraperCache::Entry entry;
+	bool isCached = ScraperCache::get(mCacheKey, entry);
+	if (isCached && entry.fresh)
+	{
+		LOG(LogDebug) << "ScraperHttpRequest : using cached response for " << mCacheKey;
+
+		mCachedContent = entry.body;
+		mIsCached = true;
+		return;
+	}
+
+	// Another request is fetching the same url : wait for its response, update() restarts this one when it's done
+	if (!ScraperCache::beginFetch(mCacheKey))
+	{
+		mWaitingForFetch = true;
+		return;
+	}
+
+	mIsFetching = true;
+
+	// Revalidate the stale entry : a 304 response costs no data
+	if (isCached && !entry.etag.empty())
+	{
+		mRequestOptions.customHeaders.push_back("If-None-Match: " + entry.etag);
+		mCachedContent = entry.body;
+	}
+
+	sendRequest();
+}
+
+void ScraperHttpRequest::sendRequest()
+{
+	// The rate limiter decides when the request can go, update() asks again until then
+	mWaitingForSlot = !ScraperRateLimiter::tryAcquire(ScraperRateLimiter::SEARCH);
+	if (mWaitingForSlot)
+		return;
+
+	mHasSlot = true;
+	mRequestCompleted = false;
+	mRequest = new HttpReq(mRequestUrl, &mRequestOptions);
+	mCompletionNotified = mRequest->setOnCompleted([this](HttpReq* request) { mRequestCompleted = true; });
+}
+
+void ScraperHttpRequest::releaseSlot(int status)
+{
+	if (!mHasSlot)
+		return;
+
+	ScraperRateLimiter::release(ScraperRateLimiter::SEARCH, mRequest, status);
+	mHasSlot = false;
+}
+
+void ScraperHttpRequest::endFetch()
+{
+	if (!mIsFetching)
+		return;
+
+	ScraperCache::endFetch(mCacheKey);
+	mIsFetching = false;
 }
 
 std::string ScraperHttpRequest::getDependencyResponse(const std::string& id) const
@@ -297,23 +413,66 @@ void ScraperHttpRequest::update()
 
 			LOG(LogDebug) << "REQ_429_TOOMANYREQUESTS : Retrying";
 
-			std::string url = mRequest->getUrl();
-			delete mRequest;
-			mRequest = new HttpReq(url, &mOptions);
+			startRequest(mRequestUrl);
 		}
 
 		return;
 	}
 
-	HttpReq::Status status = mRequest->status();
+	if (mWaitingForFetch)
+	{
+		if (ScraperCache::isFetching(mCacheKey))
+			return;
+
+		// The response is in the cache now, unless the other request failed : then this one fetches it
+		mWaitingForFetch = false;
+		startRequest(mRequestUrl);
+		return;
+	}
+
+	if (mWaitingForSlot)
+	{
+		// Another request has spent the quota : this one would be refused too
+		if (ScraperRateLimiter::isQuotaExhausted())
+		{
+			setError(HttpReq::REQ_430_TOOMANYSCRAPS, "Scraping quota exhausted");
+			return;
+		}
+
+		sendRequest();
+		return;
+	}
+
+	// not completed yet, without reading the request state
+	if (!mIsCached && isCompletionPending(mCompletionNotified, mRequestCompleted, mLastPollTime))
+		return;
+
+	HttpReq::Status status = mIsCached ? HttpReq::REQ_SUCCESS : mRequest->status();
 
 	// not ready yet
 	if (status == HttpReq::REQ_IN_PROGRESS)
 		return;
 
+	releaseSlot(status);
+
+	std::string body;
+
+	if (mIsCached)
+		body = mCachedContent;
+	else if (status == HttpReq::REQ_304_NOTMODIFIED)
+	{
+		body = mCachedContent;
+		status = HttpReq::REQ_SUCCESS;
+	}
+	else if (status == HttpReq::REQ_SUCCESS)
+		body = mRequest->getContent();
+
+	// Stored once process() has accepted the whole response : some servers send their errors with a 200 status
+	if (mIsFetching && status == HttpReq::REQ_SUCCESS)
+		mPendingCache.push_back(PendingCacheEntry { mCacheKey, body, ScraperCache::getETag(mRequest) });
+
 	if (status == HttpReq::REQ_SUCCESS)
 	{
-		std::string body = mRequest->getContent();
 		mResponses[mDependencyId] = body;
 
 		if (mDependencyId.empty())
@@ -327,17 +486,26 @@ void ScraperHttpRequest::update()
 			mDependencyQueue.pop();
 
 			mDependencyId = item.first;
-			std::string url = item.second;	
-			delete mRequest;
-			mRequest = new HttpReq(url, &mOptions);
+			endFetch();
+			startRequest(item.second);
 			return;
 		}
 
 		setStatus(ASYNC_DONE); // if process() has an error, status will be changed to ASYNC_ERROR
-		process(mResponses[""], mResults);
+		if (process(mResponses[""], mResults) && mStatus == ASYNC_DONE)
+		{
+			for (auto& entry : mPendingCache)
+				ScraperCache::put(entry.key, entry.body, entry.etag);
+		}
+
+		mPendingCache.clear();
+		endFetch();
 		return;
 	}
 
+	mPendingCache.clear();
+	endFetch();
+
 	if (status == HttpReq::REQ_429_TOOMANYREQUESTS)
 	{
 		mRetryCount++;
@@ -368,6 +536,21 @@ void ScraperHttpRequest::update()
 		return;
 	}
 
+	// Quota spent, but the server says when it comes back : the rate limiter holds every request until then
+	if ((status == HttpReq::REQ_430_TOOMANYSCRAPS || status == HttpReq::REQ_430_TOOMANYFAILURES) && !mRequest->getResponseHeader("Retry-After").empty())
+	{
+		mRetryCount++;
+		if (mRetryCount < mOverQuotaRetryCount)
+		{
+			setStatus(ASYNC_IN_PROGRESS);
+
+			mOverQuotaRetryDelay = Utils::String::toInteger(mRequest->getResponseHeader("Retry-After")) * 1000;
+			mOverQuotaPendingTime = SDL_GetTicks();
+			LOG(LogDebug) << "REQ_430_TOOMANYSCRAPS : Retrying in " << mOverQuotaRetryDelay << " ms";
+			return;
+		}
+	}
+
 	// Ignored errors
 	if (status == HttpReq::REQ_404_NOTFOUND || status == HttpReq::REQ_IO_ERROR)
 	{
@@ -479,11 +662,43 @@ void MDResolveHandle::update()
 {
 	if(mStatus == ASYNC_DONE || mStatus == ASYNC_ERROR)
 		return;
+
+	// Medias which are downloaded, waiting for the media processing pool
+	for (auto it = mPostProcessing.begin(); it != mPostProcessing.end(); )
+	{
+		ResolvePair* pPair = (*it);
+
+		auto status = pPair->handle->status();
+		if (status == ASYNC_IN_PROGRESS)
+		{
+			++it;
+			continue;
+		}
+
+		if (status == ASYNC_ERROR)
+		{
+			setError(pPair->handle->getErrorCode(), pPair->handle->getStatusString());
+			for (auto fc : mFuncs)
+				delete fc;
+
+			for (auto fc : mPostProcessing)
+				delete fc;
+
+			mPostProcessing.clear();
+			return;
+		}
+
+		pPair->onFinished(pPair->handle.get());
+		it = mPostProcessing.erase(it);
+		delete pPair;
+	}
 	
 	auto it = mFuncs.cbegin();
 	if (it == mFuncs.cend())
 	{
-		setStatus(ASYNC_DONE);
+		if (mPostProcessing.empty())
+			setStatus(ASYNC_DONE);
+
 		return;
 	}
 
@@ -498,13 +713,23 @@ void MDResolveHandle::update()
 		for (auto fc : mFuncs)
 			delete fc;
 
+		for (auto fc : mPostProcessing)
+			delete fc;
+
+		mPostProcessing.clear();
 		return;
 	}
-	else if (pPair->handle->status() == ASYNC_DONE)
+	else if (pPair->handle->status() == ASYNC_DONE || pPair->handle->isPostProcessing())
 	{		
-		pPair->onFinished(pPair->handle.get());
+		if (pPair->handle->status() == ASYNC_DONE)
+		{
+			pPair->onFinished(pPair->handle.get());
+			delete pPair;
+		}
+		else // Download the next media meanwhile
+			mPostProcessing.push_back(pPair);
+
 		mFuncs.erase(it);
-		delete pPair;
 
 		auto next = mFuncs.cbegin();
 		if (next != mFuncs.cend())
@@ -515,7 +740,7 @@ void MDResolveHandle::update()
 		}
 	}
 	
-	if(mFuncs.empty())
+	if(mFuncs.empty() && mPostProcessing.empty())
 		setStatus(ASYNC_DONE);
 }
 
@@ -531,13 +756,22 @@ std::unique_ptr<ImageDownloadHandle> MDResolveHandle::downloadImageAsync(const s
 ImageDownloadHandle::ImageDownloadHandle(const std::string& url, const std::string& path, int maxWidth, int maxHeight) : 
 	mSavePath(path), mMaxWidth(maxWidth), mMaxHeight(maxHeight)
 {
+	mRequest = nullptr;
+	mWaitingForSlot = false;
+	mHasSlot = false;
+	mDownloadStartTime = 0;
+	mCompletionNotified = false;
+	mRequestCompleted = false;
+	mLastPollTime = 0;
+	mWaitingForProcessing = false;
 	mRetryCount = 0;
 	mOverQuotaPendingTime = 0;
 	mOverQuotaRetryDelay = OVERQUOTA_RETRY_DELAY;
 	mOverQuotaRetryCount = OVERQUOTA_RETRY_COUNT;
 
-	HttpReqOptions options;
+	HttpReqOptions& options = mOptions;
 	options.outputFilename = path;
+	options.resumeDownload = true;
 
 	if (url.find("screenscraper") != std::string::npos && url.find("/medias/") != std::string::npos)
 	{
@@ -561,20 +795,61 @@ ImageDownloadHandle::ImageDownloadHandle(const std::string& url, const std::stri
 			uri.arguments.set("maxheight", std::to_string(maxHeight));
 		}
 
-		mRequest = new HttpReq(uri.toString(), &options);
+		mUrl = uri.toString();
 	}
 	else
-		mRequest = new HttpReq(url, &options);
+		mUrl = url;
+
+	sendRequest();
 }
 
 ImageDownloadHandle::~ImageDownloadHandle()
 {
-	delete mRequest;
+	releaseSlot(0);
+
+	if (mRequest != nullptr)
+		delete mRequest;
+}
+
+void ImageDownloadHandle::sendRequest()
+{
+	// Media downloads have their own lane : they never delay the searches of the other games
+	mWaitingForSlot = !ScraperRateLimiter::tryAcquire(ScraperRateLimiter::MEDIA);
+	if (mWaitingForSlot)
+		return;
+
+	if (mRequest != nullptr)
+		delete mRequest;
+
+	mHasSlot = true;
+	mDownloadStartTime = SDL_GetTicks();
+	mRequestCompleted = false;
+	mRequest = new HttpReq(mUrl, &mOptions);
+	mCompletionNotified = mRequest->setOnCompleted([this](HttpReq* request) { mRequestCompleted = true; });
+}
+
+void ImageDownloadHandle::queueProcessing()
+{
+	std::string path = mSavePath;
+	int maxWidth = mMaxWidth;
+	int maxHeight = mMaxHeight;
+
+	mProcessing = ScraperMediaProcessor::queueJob([path, maxWidth, maxHeight]() { return resizeImage(path, maxWidth, maxHeight); });
+	mWaitingForProcessing = (mProcessing == nullptr);
+}
+
+void ImageDownloadHandle::releaseSlot(int status)
+{
+	if (!mHasSlot)
+		return;
+
+	ScraperRateLimiter::release(ScraperRateLimiter::MEDIA, mRequest, status);
+	mHasSlot = false;
 }
 
 int ImageDownloadHandle::getPercent()
 {
-	if (mRequest->status() == HttpReq::REQ_IN_PROGRESS)
+	if (mRequest != nullptr && !mWaitingForSlot && mRequest->status() == HttpReq::REQ_IN_PROGRESS)
 		return mRequest->getPercent();
 
 	return -1;
@@ -582,6 +857,23 @@ int ImageDownloadHandle::getPercent()
 
 void ImageDownloadHandle::update()
 {
+	if (mProcessing != nullptr)
+	{
+		if (mProcessing->isDone())
+		{
+			mProcessing = nullptr;
+			setStatus(ASYNC_DONE);
+		}
+
+		return;
+	}
+
+	if (mWaitingForProcessing)
+	{
+		queueProcessing();
+		return;
+	}
+
 	if (mOverQuotaPendingTime > 0)
 	{
 		int lastTime = SDL_GetTicks();
@@ -590,19 +882,35 @@ void ImageDownloadHandle::update()
 			mOverQuotaPendingTime = 0;
 
 			LOG(LogDebug) << "REQ_429_TOOMANYREQUESTS : Retrying";
+			sendRequest();
+		}
+
+		return;
+	}
 
-			std::string url = mRequest->getUrl();
-			delete mRequest;
-			mRequest = new HttpReq(url, mSavePath);
+	if (mWaitingForSlot)
+	{
+		// Another request has spent the quota : this one would be refused too
+		if (ScraperRateLimiter::isQuotaExhausted())
+		{
+			setError(HttpReq::REQ_430_TOOMANYSCRAPS, "Scraping quota exhausted");
+			return;
 		}
 
+		sendRequest();
 		return;
 	}
 
+	// not completed yet, without reading the request state
+	if (isCompletionPending(mCompletionNotified, mRequestCompleted, mLastPollTime))
+		return;
+
 	HttpReq::Status status = mRequest->status();
 
 	if (status == HttpReq::REQ_IN_PROGRESS)
 		return;
+
+	releaseSlot(status);
 	
 	if (status == HttpReq::REQ_429_TOOMANYREQUESTS)
 	{
@@ -627,6 +935,21 @@ void ImageDownloadHandle::update()
 		return;
 	}
 
+	// Quota spent, but the server says when it comes back : the rate limiter holds every request until then
+	if ((status == HttpReq::REQ_430_TOOMANYSCRAPS || status == HttpReq::REQ_430_TOOMANYFAILURES) && !mRequest->getResponseHeader("Retry-After").empty())
+	{
+		mRetryCount++;
+		if (mRetryCount < mOverQuotaRetryCount)
+		{
+			setStatus(ASYNC_IN_PROGRESS);
+
+			mOverQuotaRetryDelay = Utils::String::toInteger(mRequest->getResponseHeader("Retry-After")) * 1000;
+			mOverQuotaPendingTime = SDL_GetTicks();
+			LOG(LogDebug) << "REQ_430_TOOMANYSCRAPS : Retrying in " << mOverQuotaRetryDelay << " ms";
+			return;
+		}
+	}
+
 	// Ignored errors
 	if (status == HttpReq::REQ_404_NOTFOUND || status == HttpReq::REQ_IO_ERROR)
 	{
@@ -643,6 +966,8 @@ void ImageDownloadHandle::update()
 
 	if (status == HttpReq::REQ_SUCCESS && mStatus == ASYNC_IN_PROGRESS)
 	{
+		ScraperMediaProcessor::recordStage(ScraperMediaProcessor::DOWNLOAD, SDL_GetTicks() - mDownloadStartTime, mRequest->getPosition());
+
 		std::string ext = Utils::String::toLower(Utils::FileSystem::getExtension(mSavePath));
 
 		// Make sure extension is the good one, according to the response 'Content-Type'
@@ -680,8 +1005,12 @@ void ImageDownloadHandle::update()
 		// It's an image ?
 		if (mSavePath.find("-fanart") == std::string::npos && mSavePath.find("-bezel") == std::string::npos && mSavePath.find("-map") == std::string::npos && (ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp" || ext == ".gif"))
 		{
-			try { resizeImage(mSavePath, mMaxWidth, mMaxHeight); }
-			catch(...) { }
+			// The download slot is already free for the next media
+			if (mMaxWidth != 0 || mMaxHeight != 0)
+			{
+				queueProcessing();
+				return;
+			}
 		}
 	}
 
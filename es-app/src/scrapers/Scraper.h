@@ -5,6 +5,8 @@
 #include "AsyncHandle.h"
 #include "HttpReq.h"
 #include "MetaData.h"
+#include "scrapers/ScraperMediaProcessor.h"
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <queue>
@@ -99,11 +101,44 @@ protected:
 	virtual bool process(const std::string& response, std::vector<ScraperSearchResult>& results) = 0;
 	virtual void preProcess(const std::string& response) { }
 
+	// The response isn't an answer to the request, even if process() doesn't fail : it must not be cached
+	void skipCache() { mPendingCache.clear(); }
+
 private:
+	void startRequest(const std::string& url);
+	void sendRequest();
+	void releaseSlot(int status);
+	void endFetch();
+
 	HttpReq* mRequest;
 	HttpReqOptions mOptions;
 	int	mRetryCount;
 
+	std::string mRequestUrl;
+	HttpReqOptions mRequestOptions;
+	bool mWaitingForSlot;
+	bool mHasSlot;
+
+	// Set on the UI thread when mRequest completes, so update() doesn't poll it
+	bool mCompletionNotified;
+	std::atomic<bool> mRequestCompleted;
+	unsigned int mLastPollTime;
+
+	std::string mCacheKey;
+	std::string mCachedContent;
+	bool mIsCached;
+	bool mIsFetching;
+	bool mWaitingForFetch;
+
+	struct PendingCacheEntry
+	{
+		std::string key;
+		std::string body;
+		std::string etag;
+	};
+
+	std::vector<PendingCacheEntry> mPendingCache;
+
 	int mOverQuotaPendingTime;
 	int mOverQuotaRetryDelay;
 	int mOverQuotaRetryCount;
@@ -147,8 +182,28 @@ public:
 	virtual int getPercent();
 	std::string getImageFileName() { return mSavePath; }
 
+	// Downloaded, waiting for the media processing pool
+	bool isPostProcessing() { return mProcessing != nullptr || mWaitingForProcessing; }
+
 private:
+	void sendRequest();
+	void releaseSlot(int status);
+	void queueProcessing();
+
 	HttpReq* mRequest;
+	std::string mUrl;
+	HttpReqOptions mOptions;
+	bool mWaitingForSlot;
+	bool mHasSlot;
+	unsigned int mDownloadStartTime;
+
+	// Set on the UI thread when mRequest completes, so update() doesn't poll it
+	bool mCompletionNotified;
+	std::atomic<bool> mRequestCompleted;
+	unsigned int mLastPollTime;
+
+	ScraperMediaProcessor::JobPtr mProcessing;
+	bool mWaitingForProcessing;
 
 	int	mRetryCount;
 	int mOverQuotaPendingTime;
@@ -214,6 +269,7 @@ private:
 	};
 
 	std::vector<ResolvePair*> mFuncs;
+	std::vector<ResolvePair*> mPostProcessing;
 	std::string mCurrentItem;
 	std::string mSource;
 	int mPercent;
@@ -273,6 +329,9 @@ public:
 		return 1;
 	}
 
+	// Known after getThreadCount, 0 if the provider doesn't tell
+	virtual int getMaxRequestsPerMinute() { return 0; }
+
 	bool isMediaSupported(const ScraperMediaSource& md);
 
 protected:
@@ -0,0 +1,238 @@
+#include "scrapers/ScraperCache.h"
+
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+#include "HttpReq.h"
+#include "Settings.h"
+#include "Paths.h"
+#include "Log.h"
+#include <algorithm>
+#include <vector>
+#include <stdio.h>
+#include <time.h>
+
+#define SCRAPER_CACHE_MAGIC 0x43535345 // "ESSC"
+#define SCRAPER_CACHE_VERSION 1
+#define SCRAPER_CACHE_MAX_AGE	(90 * 86400) // s
+#define SCRAPER_CACHE_MAX_SIZE	(64ULL * 1024 * 1024) // bytes
+
+std::mutex				ScraperCache::sLock;
+std::set<std::string>	ScraperCache::sFetching;
+
+// Query parameters holding credentials : they are not part of the cache key
+static const std::set<std::string> sCredentialParameters = { "devid", "devpassword", "softname", "ssid", "sspassword", "apikey", "api_key", "client_id", "client_secret", "token" };
+
+static std::string getScraperCachePath()
+{
+	return Utils::FileSystem::getGenericPath(Paths::getUserEmulationStationPath() + "/tmp/scrapercache");
+}
+
+static FILE* openFile(const std::string& path, const char* mode)
+{
+#if defined(_WIN32)
+	return _wfopen(Utils::String::convertToWideString(path).c_str(), Utils::String::convertToWideString(mode).c_str());
+#else
+	return fopen(path.c_str(), mode);
+#endif
+}
+
+bool ScraperCache::isEnabled()
+{
+	return Settings::getInstance()->getBool("ScrapeCache");
+}
+
+std::string ScraperCache::getKey(const std::string& url, const HttpReqOptions& options)
+{
+	std::string base = url;
+	std::vector<std::string> parameters;
+
+	auto pos = url.find('?');
+	if (pos != std::string::npos)
+	{
+		base = url.substr(0, pos);
+
+		for (auto parameter : Utils::String::split(url.substr(pos + 1), '&', true))
+		{
+			std::string name = Utils::String::toLower(parameter.substr(0, parameter.find('=')));
+			if (sCredentialParameters.find(name) == sCredentialParameters.cend())
+				parameters.push_back(parameter);
+		}
+
+		// The same request written with another parameter order shares the entry
+		std::sort(parameters.begin(), parameters.end());
+	}
+
+	std::string key = base;
+	if (!parameters.empty())
+		key += "?" + Utils::String::join(parameters, "&");
+
+	if (!options.dataToPost.empty())
+		key += "|" + options.dataToPost;
+
+	return key;
+}
+
+std::string ScraperCache::getFilePath(const std::string& key)
+{
+	char hash[32];
+	snprintf(hash, sizeof(hash), "%016llx", (unsigned long long) std::hash<std::string>()(key));
+
+	return getScraperCachePath() + "/" + hash + ".bin";
+}
+
+void ScraperCache::purge()
+{
+	std::unique_lock<std::mutex> lock(sLock);
+
+	std::string path = getScraperCachePath();
+	if (!Utils::FileSystem::exists(path))
+		return;
+
+	// Stale entries are still worth an ETag revalidation, until they are really old
+	long long maxAge = std::max((long long)SCRAPER_CACHE_MAX_AGE, (long long)Settings::getInstance()->getInt("ScrapeCacheDays") * 86400);
+	long long now = (long long)time(nullptr);
+
+	std::vector<std::pair<time_t, std::string>> files;
+	unsigned long long totalSize = 0;
+	int removed = 0;
+
+	for (auto file : Utils::FileSystem::getDirContent(path))
+	{
+		if (Utils::FileSystem::getExtension(file) != ".bin")
+			continue;
+
+		time_t date = Utils::FileSystem::getFileModificationDate(file).getTime();
+		if (now - (long long)date > maxAge)
+		{
+			Utils::FileSystem::removeFile(file);
+			removed++;
+			continue;
+		}
+
+		totalSize += Utils::FileSystem::getFileSize(file);
+		files.push_back(std::make_pair(date, file));
+	}
+
+	std::sort(files.begin(), files.end());
+
+	for (auto& file : files)
+	{
+		if (totalSize <= SCRAPER_CACHE_MAX_SIZE)
+			break;
+
+		totalSize -= std::min(totalSize, (unsigned long long)Utils::FileSystem::getFileSize(file.second));
+		Utils::FileSystem::removeFile(file.second);
+		removed++;
+	}
+
+	if (removed > 0)
+		LOG(LogInfo) << "ScraperCache : purged " << removed << " entries";
+}
+
+bool ScraperCache::get(const std::string& key, Entry& entry)
+{
+	std::unique_lock<std::mutex> lock(sLock);
+
+	FILE* file = openFile(getFilePath(key), "rb");
+	if (file == nullptr)
+		return false;
+
+	bool valid = false;
+
+	unsigned int header[4];
+	long long date = 0;
+
+	if (fread(header, sizeof(unsigned int), 4, file) == 4 && header[0] == SCRAPER_CACHE_MAGIC && header[1] == SCRAPER_CACHE_VERSION && header[2] == key.size() &&
+		fread(&date, sizeof(long long), 1, file) == 1)
+	{
+		std::string storedKey(header[2], '\0');
+		entry.etag = std::string(header[3], '\0');
+
+		if (fread(&storedKey[0], 1, storedKey.size(), file) == storedKey.size() && storedKey == key &&
+			(entry.etag.empty() || fread(&entry.etag[0], 1, entry.etag.size(), file) == entry.etag.size()))
+		{
+			char buffer[16384];
+			size_t read;
+
+			entry.body.clear();
+			while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+				entry.body.append(buffer, read);
+
+			valid = !entry.body.empty();
+		}
+	}
+
+	fclose(file);
+
+	if (!valid)
+		return false;
+
+	long long ttl = (long long)Settings::getInstance()->getInt("ScrapeCacheDays") * 86400;
+	entry.fresh = (long long)time(nullptr) - date < ttl;
+	return true;
+}
+
+void ScraperCache::put(const std::string& key, const std::string& body, const std::string& etag)
+{
+	if (body.empty())
+		return;
+
+	std::unique_lock<std::mutex> lock(sLock);
+
+	std::string path = getScraperCachePath();
+	if (!Utils::FileSystem::exists(path))
+		Utils::FileSystem::createDirectory(path);
+
+	std::string filePath = getFilePath(key);
+
+	FILE* file = openFile(filePath, "wb");
+	if (file == nullptr)
+	{
+		LOG(LogWarning) << "ScraperCache : unable to write " << filePath;
+		return;
+	}
+
+	unsigned int header[4] = { SCRAPER_CACHE_MAGIC, SCRAPER_CACHE_VERSION, (unsigned int)key.size(), (unsigned int)etag.size() };
+	long long date = (long long)time(nullptr);
+
+	bool written =
+		fwrite(header, sizeof(unsigned int), 4, file) == 4 &&
+		fwrite(&date, sizeof(long long), 1, file) == 1 &&
+		fwrite(key.data(), 1, key.size(), file) == key.size() &&
+		fwrite(etag.data(), 1, etag.size(), file) == etag.size() &&
+		fwrite(body.data(), 1, body.size(), file) == body.size();
+
+	fclose(file);
+
+	// Never leave a truncated entry (disk full...)
+	if (!written)
+		Utils::FileSystem::removeFile(filePath);
+}
+
+std::string ScraperCache::getETag(HttpReq* request)
+{
+	// HTTP/2 header names are lowercase
+	for (auto header : request->getResponseHeaders())
+		if (Utils::String::toLower(header.first) == "etag")
+			return header.second;
+
+	return "";
+}
+
+bool ScraperCache::beginFetch(const std::string& key)
+{
+	std::unique_lock<std::mutex> lock(sLock);
+	return sFetching.insert(key).second;
+}
+
+bool ScraperCache::isFetching(const std::string& key)
+{
+	std::unique_lock<std::mutex> lock(sLock);
+	return sFetching.find(key) != sFetching.cend();
+}
+
+void ScraperCache::endFetch(const std::string& key)
+{
+	std::unique_lock<std::mutex> lock(sLock);
+	sFetching.erase(key);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#ifndef ES_APP_SCRAPERS_SCRAPER_CACHE_H
+#define ES_APP_SCRAPERS_SCRAPER_CACHE_H
+
+#include <mutex>
+#include <set>
+#include <string>
+
+class HttpReq;
+class HttpReqOptions;
+
+// Scraper API responses, stored in ~/.emulationstation/tmp/scrapercache so re-scraping a system doesn't spend the daily quotas again.
+// Entries are keyed by the request url & posted data, without the credentials. Stale entries are revalidated with their ETag.
+// Identical requests running at the same time are coalesced : the first one fetches, the others wait for its result.
+// The folder is purged when a batch scrape starts : old entries first, then the oldest ones until it fits the size cap.
+class ScraperCache
+{
+public:
+	struct Entry
+	{
+		Entry() : fresh(false) { }
+
+		std::string body;
+		std::string etag;
+		bool fresh;
+	};
+
+	static bool isEnabled();
+	static std::string getKey(const std::string& url, const HttpReqOptions& options);
+
+	static bool get(const std::string& key, Entry& entry);
+	static void put(const std::string& key, const std::string& body, const std::string& etag);
+
+	static std::string getETag(HttpReq* request);
+
+	static void purge();
+
+	// Returns false if the key is already being fetched by another request
+	static bool beginFetch(const std::string& key);
+	static bool isFetching(const std::string& key);
+	static void endFetch(const std::string& key);
+
+private:
+	static std::string getFilePath(const std::string& key);
+
+	static std::mutex				sLock;
+	static std::set<std::string>	sFetching;
+};
+
+#endif // ES_APP_SCRAPERS_SCRAPER_CACHE_H
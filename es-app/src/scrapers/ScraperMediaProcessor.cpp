@@ -0,0 +1,142 @@
+#include "scrapers/ScraperMediaProcessor.h"
+
+#include "Log.h"
+#include <algorithm>
+#include <stdio.h>
+#include <SDL_timer.h>
+
+#define SCRAPER_MEDIA_MAX_THREADS	4
+#define SCRAPER_MEDIA_QUEUE_SIZE	16
+
+std::mutex							ScraperMediaProcessor::sLock;
+std::condition_variable				ScraperMediaProcessor::sEvent;
+std::deque<ScraperMediaProcessor::JobPtr> ScraperMediaProcessor::sQueue;
+std::vector<std::thread*>			ScraperMediaProcessor::sThreads;
+std::atomic<bool>					ScraperMediaProcessor::sStopping(false);
+
+ScraperMediaProcessor::StageStatistics ScraperMediaProcessor::sStatistics[2];
+unsigned int						ScraperMediaProcessor::sStatisticsStart = 0;
+
+ScraperMediaProcessor::JobPtr ScraperMediaProcessor::queueJob(const std::function<bool()>& work)
+{
+	std::unique_lock<std::mutex> lock(sLock);
+
+	if (sStopping || sQueue.size() >= SCRAPER_MEDIA_QUEUE_SIZE)
+		return nullptr;
+
+	if (sThreads.empty())
+	{
+		// Leave some cores to the UI & the downloads
+		int count = std::max(1, std::min(SCRAPER_MEDIA_MAX_THREADS, (int)std::thread::hardware_concurrency() / 2));
+		for (int i = 0; i < count; i++)
+			sThreads.push_back(new std::thread(&ScraperMediaProcessor::run));
+	}
+
+	auto job = std::make_shared<Job>(work);
+	sQueue.push_back(job);
+	sEvent.notify_one();
+	return job;
+}
+
+void ScraperMediaProcessor::stop()
+{
+	{
+		std::unique_lock<std::mutex> lock(sLock);
+		if (sThreads.empty())
+			return;
+
+		sStopping = true;
+
+		// Nobody waits for the queued jobs anymore
+		for (auto job : sQueue)
+			job->mDone = true;
+
+		sQueue.clear();
+	}
+
+	sEvent.notify_all();
+
+	for (auto thread : sThreads)
+	{
+		thread->join();
+		delete thread;
+	}
+
+	std::unique_lock<std::mutex> lock(sLock);
+	sThreads.clear();
+	sStopping = false;
+}
+
+void ScraperMediaProcessor::run()
+{
+	while (true)
+	{
+		JobPtr job;
+
+		{
+			std::unique_lock<std::mutex> lock(sLock);
+			sEvent.wait(lock, [] { return sStopping || !sQueue.empty(); });
+
+			if (sStopping)
+				break;
+
+			job = sQueue.front();
+			sQueue.pop_front();
+		}
+
+		unsigned int start = SDL_GetTicks();
+
+		try { job->mResult = job->mWork(); }
+		catch (...) { job->mResult = false; }
+
+		recordStage(PROCESSING, SDL_GetTicks() - start);
+		job->mDone = true;
+	}
+}
+
+void ScraperMediaProcessor::recordStage(Stage stage, int duration, long long bytes)
+{
+	std::unique_lock<std::mutex> lock(sLock);
+
+	auto& statistics = sStatistics[stage];
+	statistics.count++;
+	statistics.bytes += std::max(0LL, bytes);
+	statistics.duration += std::max(0, duration);
+}
+
+void ScraperMediaProcessor::resetStatistics()
+{
+	std::unique_lock<std::mutex> lock(sLock);
+
+	for (auto& statistics : sStatistics)
+		statistics = StageStatistics { 0, 0, 0 };
+
+	sStatisticsStart = SDL_GetTicks();
+}
+
+std::string ScraperMediaProcessor::getStatistics()
+{
+	std::unique_lock<std::mutex> lock(sLock);
+
+	const char* names[] = { "download", "processing" };
+
+	double elapsed = std::max(1u, SDL_GetTicks() - sStatisticsStart) / 1000.0;
+
+	std::string ret;
+
+	for (int i = 0; i < 2; i++)
+	{
+		auto& statistics = sStatistics[i];
+
+		char buffer[256];
+		snprintf(buffer, sizeof(buffer), "%s%s : %d medias, %.1f/s, %lld ms avg, %.1f KB/s", ret.empty() ? "" : " - ", names[i],
+			statistics.count,
+			statistics.count / elapsed,
+			statistics.count > 0 ? statistics.duration / statistics.count : 0LL,
+			statistics.bytes / 1024.0 / elapsed);
+
+		ret += buffer;
+	}
+
+	return ret;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#ifndef ES_APP_SCRAPERS_SCRAPER_MEDIA_PROCESSOR_H
+#define ES_APP_SCRAPERS_SCRAPER_MEDIA_PROCESSOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Bounded pool of worker threads post-processing the scraped medias (resizing, re-encoding...), fed by the downloads.
+// The scraper thread only queues the work, so the downloads of the next medias overlap the processing of the previous ones.
+// Also keeps the throughput of each stage of the scraping pipeline.
+class ScraperMediaProcessor
+{
+public:
+	class Job
+	{
+	public:
+		Job(const std::function<bool()>& work) : mWork(work), mDone(false), mResult(false) { }
+
+		bool isDone() const { return mDone; }
+		bool getResult() const { return mResult; }
+
+	private:
+		friend class ScraperMediaProcessor;
+
+		std::function<bool()> mWork;
+		std::atomic<bool> mDone;
+		bool mResult;
+	};
+
+	typedef std::shared_ptr<Job> JobPtr;
+
+	// Returns nullptr if the queue is full : the caller tries again later
+	static JobPtr queueJob(const std::function<bool()>& work);
+	static void stop();
+
+	enum Stage
+	{
+		DOWNLOAD = 0,
+		PROCESSING = 1
+	};
+
+	static void recordStage(Stage stage, int duration, long long bytes = 0);
+	static void resetStatistics();
+	static std::string getStatistics();
+
+private:
+	static void run();
+
+	struct StageStatistics
+	{
+		int count;
+		long long bytes;
+		long long duration;
+	};
+
+	static std::mutex					sLock;
+	static std::condition_variable		sEvent;
+	static std::deque<JobPtr>			sQueue;
+	static std::vector<std::thread*>	sThreads;
+	static std::atomic<bool>			sStopping;
+
+	static StageStatistics				sStatistics[2];
+	static unsigned int					sStatisticsStart;
+};
+
+#endif // ES_APP_SCRAPERS_SCRAPER_MEDIA_PROCESSOR_H
@@ -0,0 +1,193 @@
+#include "scrapers/ScraperRateLimiter.h"
+
+#include "utils/StringUtil.h"
+#include "HttpReq.h"
+#include "Log.h"
+#include <algorithm>
+#include <time.h>
+#include <SDL_timer.h>
+
+#define SCRAPER_DEFAULT_CONCURRENCY		4
+#define SCRAPER_UNLIMITED_RATE			20.0  // requests per second
+#define SCRAPER_MIN_RATE				0.1
+#define SCRAPER_RATE_INCREASE			0.05  // added on each success
+#define SCRAPER_DEFAULT_BACKOFF			5000  // ms, when the server doesn't say how long to wait
+#define SCRAPER_QUOTA_BACKOFF			3600  // s, when the quota is spent & the server doesn't say until when
+
+std::mutex						ScraperRateLimiter::sLock;
+ScraperRateLimiter::Bucket		ScraperRateLimiter::sBuckets[2];
+int								ScraperRateLimiter::sActive = 0;
+int								ScraperRateLimiter::sMaxActive = SCRAPER_DEFAULT_CONCURRENCY;
+time_t							ScraperRateLimiter::sQuotaExhaustedUntil = 0;
+bool							ScraperRateLimiter::sInitialized = false;
+
+static int getHeaderValue(HttpReq* request, const std::string& name, const std::string& alternateName)
+{
+	for (auto header : request->getResponseHeaders())
+	{
+		std::string key = Utils::String::toLower(header.first);
+		if (key != name && key != alternateName)
+			continue;
+
+		int value = Utils::String::toInteger(header.second);
+
+		// Some servers send the reset time as an epoch instead of a delay
+		if (value > 86400 * 365)
+			value -= (int)time(nullptr);
+
+		return value;
+	}
+
+	return -1;
+}
+
+void ScraperRateLimiter::initialize(Bucket& bucket, int concurrency, int maxRequestsPerMinute)
+{
+	bucket.maxRate = maxRequestsPerMinute > 0 ? maxRequestsPerMinute / 60.0 : SCRAPER_UNLIMITED_RATE;
+	bucket.rate = bucket.maxRate;
+	bucket.tokens = std::max(1, concurrency);
+	bucket.lastRefill = SDL_GetTicks();
+	bucket.pausedUntil = 0;
+}
+
+void ScraperRateLimiter::reset(int concurrency, int maxRequestsPerMinute)
+{
+	std::unique_lock<std::mutex> lock(sLock);
+
+	for (auto& bucket : sBuckets)
+		initialize(bucket, concurrency, maxRequestsPerMinute);
+
+	// Keep the requests which are still running
+	if (!sInitialized)
+		sActive = 0;
+
+	sMaxActive = std::max(1, concurrency);
+	sQuotaExhaustedUntil = 0;
+	sInitialized = true;
+}
+
+bool ScraperRateLimiter::tryAcquire(Lane lane)
+{
+	std::unique_lock<std::mutex> lock(sLock);
+
+	if (!sInitialized)
+	{
+		for (auto& bucket : sBuckets)
+			initialize(bucket, SCRAPER_DEFAULT_CONCURRENCY, 0);
+
+		sActive = 0;
+		sMaxActive = SCRAPER_DEFAULT_CONCURRENCY;
+		sInitialized = true;
+	}
+
+	if (sQuotaExhaustedUntil != 0)
+	{
+		if (time(nullptr) < sQuotaExhaustedUntil)
+			return false;
+
+		sQuotaExhaustedUntil = 0;
+	}
+
+	Bucket& bucket = sBuckets[lane];
+
+	unsigned now = SDL_GetTicks();
+
+	if (bucket.pausedUntil != 0)
+	{
+		if ((int)(now - bucket.pausedUntil) < 0)
+			return false;
+
+		bucket.pausedUntil = 0;
+	}
+
+	// Refill, the bucket holds at most one token per concurrent request
+	bucket.tokens = std::min((double)sMaxActive, bucket.tokens + (now - bucket.lastRefill) * bucket.rate / 1000.0);
+	bucket.lastRefill = now;
+
+	if (bucket.tokens < 1.0 || sActive >= sMaxActive)
+		return false;
+
+	bucket.tokens -= 1.0;
+	sActive++;
+	return true;
+}
+
+void ScraperRateLimiter::release(Lane lane, HttpReq* request, int status)
+{
+	std::unique_lock<std::mutex> lock(sLock);
+
+	Bucket& bucket = sBuckets[lane];
+	if (sActive > 0)
+		sActive--;
+
+	unsigned now = SDL_GetTicks();
+
+	if (status == HttpReq::REQ_430_TOOMANYSCRAPS || status == HttpReq::REQ_430_TOOMANYFAILURES)
+	{
+		int retryAfter = request != nullptr ? getHeaderValue(request, "retry-after", "x-ratelimit-reset") : -1;
+		if (retryAfter <= 0)
+		{
+			LOG(LogError) << "ScraperRateLimiter : quota exhausted, no more requests are sent for " << SCRAPER_QUOTA_BACKOFF / 60 << " minutes";
+			sQuotaExhaustedUntil = time(nullptr) + SCRAPER_QUOTA_BACKOFF;
+			return;
+		}
+
+		// The quota is shared by both lanes
+		for (auto& lanes : sBuckets)
+		{
+			lanes.tokens = 0;
+			lanes.pausedUntil = now + retryAfter * 1000;
+		}
+
+		LOG(LogDebug) << "ScraperRateLimiter : quota exhausted, waiting " << retryAfter << " s";
+		return;
+	}
+
+	if (status == HttpReq::REQ_429_TOOMANYREQUESTS)
+	{
+		int retryAfter = request != nullptr ? getHeaderValue(request, "retry-after", "x-ratelimit-reset") : -1;
+
+		bucket.rate = std::max(SCRAPER_MIN_RATE, bucket.rate / 2.0);
+		bucket.tokens = 0;
+		bucket.pausedUntil = now + (retryAfter > 0 ? retryAfter * 1000 : SCRAPER_DEFAULT_BACKOFF);
+
+		LOG(LogDebug) << "ScraperRateLimiter : lane " << (int)lane << " slowed down to " << bucket.rate << " requests/s";
+		return;
+	}
+
+	if (request != nullptr)
+	{
+		int remaining = getHeaderValue(request, "x-ratelimit-remaining", "ratelimit-remaining");
+		int reset = getHeaderValue(request, "x-ratelimit-reset", "ratelimit-reset");
+
+		if (remaining == 0 && reset > 0)
+		{
+			// Quota window spent : wait for the next one
+			bucket.tokens = 0;
+			bucket.pausedUntil = now + reset * 1000;
+			return;
+		}
+
+		if (remaining > 0 && reset > 0)
+		{
+			// Spread the remaining requests over the window
+			bucket.rate = std::max(SCRAPER_MIN_RATE, std::min(bucket.maxRate, (double)remaining / reset));
+			return;
+		}
+	}
+
+	if (status == HttpReq::REQ_SUCCESS)
+		bucket.rate = std::min(bucket.maxRate, bucket.rate + SCRAPER_RATE_INCREASE);
+}
+
+bool ScraperRateLimiter::isQuotaExhausted()
+{
+	std::unique_lock<std::mutex> lock(sLock);
+	return sQuotaExhaustedUntil != 0 && time(nullptr) < sQuotaExhaustedUntil;
+}
+
+void ScraperRateLimiter::clearQuotaExhausted()
+{
+	std::unique_lock<std::mutex> lock(sLock);
+	sQuotaExhaustedUntil = 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#ifndef ES_APP_SCRAPERS_SCRAPER_RATE_LIMITER_H
+#define ES_APP_SCRAPERS_SCRAPER_RATE_LIMITER_H
+
+#include <mutex>
+#include <time.h>
+
+class HttpReq;
+
+// Token buckets shared by all the scraper requests, with a lane for metadata searches & another one for media downloads,
+// so downloads never slow down the search rate. Each lane has its own request rate, both lanes share the same concurrent requests budget.
+// The rate adapts to the server : it is halved on 429 responses, follows the RateLimit headers, and slowly grows back while requests succeed.
+// A 430 response means the quota is spent : every request waits for its Retry-After. When there's none, requests are refused
+// for SCRAPER_QUOTA_BACKOFF, or until the scraper changes or the user starts a scrape by hand.
+class ScraperRateLimiter
+{
+public:
+	enum Lane
+	{
+		SEARCH = 0,
+		MEDIA = 1
+	};
+
+	// maxRequestsPerMinute <= 0 : the provider has no known limit
+	static void reset(int concurrency, int maxRequestsPerMinute);
+
+	// Returns true if a request can be sent now. The caller must then call release once it's done
+	static bool tryAcquire(Lane lane);
+	static void release(Lane lane, HttpReq* request, int status);
+
+	// The server refused a request because the quota is spent, and didn't say when to retry
+	static bool isQuotaExhausted();
+
+	// Allows to try again, ex : another scraper is selected or the user asks for a scrape
+	static void clearQuotaExhausted();
+
+private:
+	struct Bucket
+	{
+		double		tokens;
+		double		rate;		// requests per second
+		double		maxRate;
+		unsigned	lastRefill;
+		unsigned	pausedUntil;
+	};
+
+	static void initialize(Bucket& bucket, int concurrency, int maxRequestsPerMinute);
+
+	static std::mutex	sLock;
+	static Bucket		sBuckets[2];
+	static int			sActive;
+	static int			sMaxActive;
+	static time_t		sQuotaExhaustedUntil; // 0 if the quota is not known to be spent
+	static bool			sInitialized;
+};
+
+#endif // ES_APP_SCRAPERS_SCRAPER_RATE_LIMITER_H
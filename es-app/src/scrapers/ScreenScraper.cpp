@@ -361,6 +361,9 @@ bool ScreenScraperRequest::process(const std::string& response, std::vector<Scra
 		std::string err = ss.str();
 		//setError(err); Don't consider it an error -> Request is a success. Simply : Game is not found		
 		LOG(LogWarning) << err;
+
+		// Plain text answers are errors or quota messages
+		skipCache();
 				
 		if (Utils::String::toLower(response).find("maximum threads per minute reached") != std::string::npos)
 			return false;
@@ -966,8 +969,7 @@ int ScreenScraperScraper::getThreadCount(std::string &result)
 	if (parseResult)
 	{
 		auto userInfo = ScreenScraperRequest::processUserInfo(doc);
-		
-		// userInfo.maxRequestsPerMin / userInfo.maxthreads;
+		mMaxRequestsPerMinute = userInfo.maxRequestsPerMin;
 
 		if (userInfo.maxthreads > 0)
 			return userInfo.maxthreads;
@@ -21,8 +21,12 @@ public:
 
 	bool isSupportedPlatform(SystemData* system) override;
 	int getThreadCount(std::string &result) override;
+	int getMaxRequestsPerMinute() override { return mMaxRequestsPerMinute; }
 
 	const std::set<ScraperMediaSource>& getSupportedMedias() override;
+
+private:
+	int mMaxRequestsPerMinute = 0;
 };
 
 struct ScreenScraperUser
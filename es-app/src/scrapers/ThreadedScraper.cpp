@@ -1,4 +1,7 @@
 #include "ThreadedScraper.h"
+#include "scrapers/ScraperRateLimiter.h"
+#include "scrapers/ScraperCache.h"
+#include "scrapers/ScrapeJournal.h"
 #include "Window.h"
 #include "FileData.h"
 #include "components/AsyncNotificationComponent.h"
@@ -18,6 +21,9 @@ ThreadedScraper::ThreadedScraper(Window* window, const std::queue<ScraperSearchP
 	mExitCode = ASYNC_IN_PROGRESS;
 	mTotal = (int) mSearchQueue.size();
 	mThreadCount = threadCount;
+	mJournalId = ScrapeJournal::begin(Scraper::getScraperName(Scraper::getScraper()), searches);
+
+	ScraperMediaProcessor::resetStatistics();
 }
 
 void ThreadedScraper::Process()
@@ -46,6 +52,7 @@ void ThreadedScraper::ProcessNextGame(ScraperThread* thread)
 
 	LOG(LogInfo) << "[Thread " << thread->mThreadId << "] ProcessNextGame : " << mCurrentGame;
 
+	ScrapeJournal::markStarted(item.game);
 	thread->run(item);
 
 	updateUI();
@@ -156,6 +163,11 @@ void ThreadedScraper::processError(int status, const std::string statusString)
 
 void ThreadedScraper::run()
 {
+	bool completed = false;
+
+	if (ScraperCache::isEnabled())
+		ScraperCache::purge();
+
 	while (mExitCode == ASYNC_IN_PROGRESS)
 	{
 		if (mPaused)
@@ -183,11 +195,13 @@ void ThreadedScraper::run()
 
 			case ASYNC_ERROR:
 				processError(mScraperThread->getError(), mScraperThread->getErrorString());
+
+				// Skipped, unless the error stopped the scrape : the game will be retried when it is resumed
+				if (mExitCode == ASYNC_IN_PROGRESS)
+					ScrapeJournal::markDone(mScraperThread->getSearchParams().game);
 				break;
 
 			default:
-				//std::this_thread::yield();
-				// std::this_thread::sleep_for(std::chrono::milliseconds(10));
 				break;
 			}
 
@@ -201,17 +215,27 @@ void ThreadedScraper::run()
 					if (mScraperThreads.size() == 0)
 					{
 						mExitCode = ASYNC_DONE;
+						completed = true;
 						LOG(LogDebug) << "ThreadedScraper::finished";
 					}
 					break;
 				}
 			}
 		}
+
+		// Requests run in curl's threads : polling them faster only burns a core
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
 	}
 	
+	LOG(LogInfo) << "ThreadedScraper : " << ScraperMediaProcessor::getStatistics();
+
 	if (mExitCode == ASYNC_DONE)
 		mWindow->displayNotificationMessage(GUIICON + _("SCRAPING FINISHED") + std::string(". ") + _("UPDATE GAMELISTS TO APPLY CHANGES."));
 
+	// After the results still waiting to be imported in the UI thread. An interrupted scrape keeps its journal
+	int journalId = mJournalId;
+	mWindow->postToUiThread([journalId, completed]() { ScrapeJournal::close(journalId, completed); });
+
 	delete this;
 	ThreadedScraper::mInstance = nullptr;
 }
@@ -239,6 +263,7 @@ void ThreadedScraper::acceptResult(ScraperThread& thread)
 	{		
 		auto scraperName = Scraper::getScraperName(Scraper::getScraper());
 		thread.getSearchParams().game->getMetadata().setScrapeDate(scraperName);
+		ScrapeJournal::markDone(thread.getSearchParams().game);
 		return;
 	}
 
@@ -255,6 +280,8 @@ void ThreadedScraper::acceptResult(ScraperThread& thread)
 
 		LOG(LogDebug) << "ThreadedScraper::saveToGamelistRecovery";
 		saveToGamelistRecovery(game);
+
+		ScrapeJournal::markDone(game);
 	});
 
 	LOG(LogDebug) << "ThreadedScraper::acceptResult <<";
@@ -276,7 +303,11 @@ void ThreadedScraper::start(Window* window, const std::queue<ScraperSearchParams
 	if (threadCount == 0)
 		threadCount = 1;
 
-	ThreadedScraper::mInstance = new ThreadedScraper(window, searches, threadCount);
+	// The rate limiter runs at most threadCount requests at the same time, searches & downloads together.
+	// Twice as many games are processed, so the searches of some games are ready to go while others download their medias
+	ScraperRateLimiter::reset(threadCount, Scraper::getScraper()->getMaxRequestsPerMinute());
+
+	ThreadedScraper::mInstance = new ThreadedScraper(window, searches, threadCount * 2);
 
 	try
 	{
@@ -86,6 +86,7 @@ private:
 	int mTotal;
 	int mThreadCount;
 	int mExitCode;
+	int mJournalId;
 
 	static bool mPaused;
 	static ThreadedScraper* mInstance;
@@ -181,6 +181,14 @@ int CarouselGameListView::getCursorIndex()
 	return mList.getCursorIndex();
 }
 
+FileData* CarouselGameListView::getEntryAt(int index)
+{
+	if (index < 0 || index >= mList.size())
+		return nullptr;
+
+	return dynamic_cast<FileData*>(mList.getObjectAt(index));
+}
+
 std::vector<FileData*> CarouselGameListView::getFileDataEntries()
 {
 	std::vector<FileData*> ret;
@@ -20,6 +20,7 @@ public:
 	virtual void setCursor(FileData* file) override;
 	virtual int getCursorIndex() override; 
 	virtual void setCursorIndex(int index) override; 
+	virtual FileData* getEntryAt(int index) override;
 	virtual void resetLastCursor() override;
 	virtual bool onMouseWheel(int delta) override;
 	virtual void onShow();
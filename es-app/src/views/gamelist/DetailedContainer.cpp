@@ -785,6 +785,27 @@ void DetailedContainer::loadThemedExtras(FileData* file)
 		resetThemedExtras();
 }
 
+void DetailedContainer::prerollVideos(int moveBy)
+{
+	std::vector<std::string> paths;
+
+	// The entry ahead in the cursor direction comes first. An empty list releases the pre-rolled videos
+	if (Settings::getInstance()->getBool("VideoPreroll"))
+	{
+		int cursor = mParent->getCursorIndex();
+		int direction = moveBy < 0 ? -1 : 1;
+
+		for (int index : { cursor + direction, cursor - direction })
+		{
+			FileData* file = mParent->getEntryAt(index);
+			if (file != nullptr && file->getType() == GAME && !file->getVideoPath().empty())
+				paths.push_back(file->getVideoPath());
+		}
+	}
+
+	mVideo->prerollVideos(paths);
+}
+
 void DetailedContainer::updateControls(FileData* file, bool isClearing, int moveBy, bool isDeactivating)
 {
 	bool state = (file != NULL);
@@ -828,6 +849,8 @@ void DetailedContainer::updateControls(FileData* file, bool isClearing, int move
 				snapShot = file->getMetadata(MetaDataId::Mix);
 
 			mVideo->setImage(snapShot, false, mVideo->getMaxSizeInfo());
+
+			prerollVideos(moveBy);
 		}
 
 		if (mThumbnail != nullptr)
@@ -79,6 +79,8 @@ protected:
 
 	void handleStoryBoard(GuiComponent* comp, bool activate, int moveBy, bool recursive = true);
 
+	void prerollVideos(int moveBy);
+
 	ISimpleGameListView* mParent;
 	GuiComponent* mList;
 	Window* mWindow;
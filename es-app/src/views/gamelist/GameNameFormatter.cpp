@@ -108,6 +108,14 @@ GameNameFormatter::GameNameFormatter(SystemData* system)
 
 	if (mShowSystemName && !system->isGameSystem() && system->getFolderViewMode() != "never")
 		mShowSystemName = false;
+
+	bool options[] = { mShowCheevosIcon, mShowFavoriteIcon, mShowSystemName, mShowYear, mShowSystemFirst, mShowSystemAfterYear, mShowGameTime,
+		mShowManualIcon, mShowSaveStates, mShowGunIcon, mShowWheelIcon, mShowTrackballIcon, mShowSpinnerIcon };
+
+	mFormatKey = ((unsigned long long)(mSortId & 0xFF)) | ((unsigned long long)(mShowFlags & 0xF) << 8) | ((unsigned long long)(mShowTags & 0xF) << 12);
+	for (int i = 0; i < (int)(sizeof(options) / sizeof(bool)); i++)
+		if (options[i])
+			mFormatKey |= 1ULL << (16 + i);
 }
 
 std::string valueOrDefault(const std::string value, const std::string defaultValue = _("Unknown"))
@@ -120,8 +128,6 @@ std::string valueOrDefault(const std::string value, const std::string defaultVal
 
 std::string GameNameFormatter::getDisplayName(FileData* fd, bool showFolderIcon, bool favoriteIcon, bool tagIcons)
 {
-	std::string name = fd->getName();
-
 	bool showSystemNameByFile = (fd->getType() == GAME || fd->getParent() == nullptr || fd->getParent()->getName() != "collections");
 	if (showSystemNameByFile)
 	{
@@ -131,6 +137,39 @@ std::string GameNameFormatter::getDisplayName(FileData* fd, bool showFolderIcon,
 			showSystemNameByFile = false;
 	}
 
+	// The save states are not part of the metadata : they are checked each time
+	bool saves = mShowSaveStates && fd->getSourceFileData()->getSystem()->getSaveStateRepository()->hasSaveStates(fd);
+
+	SystemData* sourceSystem = fd->getSourceFileData()->getSystem();
+
+	unsigned long long key = mFormatKey;
+	if (showFolderIcon) key |= 1ULL << 40;
+	if (favoriteIcon) key |= 1ULL << 41;
+	if (tagIcons) key |= 1ULL << 42;
+	if (showSystemNameByFile) key |= 1ULL << 43;
+	if (sourceSystem != nullptr && sourceSystem->getShowFilenames()) key |= 1ULL << 44;
+
+	FileNameCache* cache = fd->getNameCache();
+	if (cache == nullptr)
+		return formatDisplayName(fd, showSystemNameByFile, saves, showFolderIcon, favoriteIcon, tagIcons);
+
+	if (cache->displayValid && cache->displayKey == key && cache->displaySaveStates == saves &&
+		cache->displayVersion == fd->getMetadata().getVersion() && cache->displayGeneration == FileData::getSettingsGeneration())
+		return cache->displayName;
+
+	cache->displayName = formatDisplayName(fd, showSystemNameByFile, saves, showFolderIcon, favoriteIcon, tagIcons);
+	cache->displayKey = key;
+	cache->displaySaveStates = saves;
+	cache->displayVersion = fd->getMetadata().getVersion();
+	cache->displayGeneration = FileData::getSettingsGeneration();
+	cache->displayValid = true;
+	return cache->displayName;
+}
+
+std::string GameNameFormatter::formatDisplayName(FileData* fd, bool showSystemNameByFile, bool saves, bool showFolderIcon, bool favoriteIcon, bool tagIcons)
+{
+	std::string name = fd->getName();
+
 	if (mSortId != FileSorts::FILENAME_ASCENDING && mSortId != FileSorts::FILENAME_DESCENDING)
 	{
 		if (mSortId == FileSorts::GENRE_ASCENDING || mSortId == FileSorts::GENRE_DESCENDING)
@@ -227,7 +266,6 @@ std::string GameNameFormatter::getDisplayName(FileData* fd, bool showFolderIcon,
 	if (mShowCheevosIcon && fd->hasCheevos())
 		after.push_back(CHEEVOSICON);
 
-	bool saves = mShowSaveStates && fd->getSourceFileData()->getSystem()->getSaveStateRepository()->hasSaveStates(fd);
 	if (saves)
 		after.push_back(SAVESTATE);
 
@@ -10,9 +10,15 @@ class GameNameFormatter
 public:
 	GameNameFormatter(SystemData* system);
 
+	// Kept in the FileNameCache of the file while its metadata, its save states & the settings are unchanged
 	std::string getDisplayName(FileData* fd, bool showFolderIcon = true, bool favoriteIcon = true, bool tagIcons = true);
 
 private:
+	std::string formatDisplayName(FileData* fd, bool showSystemNameByFile, bool saves, bool showFolderIcon, bool favoriteIcon, bool tagIcons);
+
+	// The options above, packed
+	unsigned long long mFormatKey;
+
 	unsigned int mSortId;
 	bool mShowCheevosIcon;
 	bool mShowFavoriteIcon;	
@@ -287,6 +287,14 @@ int GridGameListView::getCursorIndex()
 	return mGrid.getCursorIndex();
 }
 
+FileData* GridGameListView::getEntryAt(int index)
+{
+	if (index < 0 || index >= mGrid.size())
+		return nullptr;
+
+	return mGrid.getObjectAt(index);
+}
+
 std::vector<FileData*> GridGameListView::getFileDataEntries()
 {
 	return mGrid.getObjects();
@@ -22,6 +22,7 @@ public:
 	virtual void setCursor(FileData*) override;
 	virtual int getCursorIndex() override; 
 	virtual void setCursorIndex(int index) override; 
+	virtual FileData* getEntryAt(int index) override;
 	virtual void resetLastCursor() override;
 	virtual void moveToRandomGame() override;
 	virtual bool onMouseWheel(int delta) override;
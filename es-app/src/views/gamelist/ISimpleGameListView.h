@@ -27,6 +27,7 @@ public:
 	virtual void setCursor(FileData*) = 0;
 	virtual int getCursorIndex() =0; 
 	virtual void setCursorIndex(int index) =0; 
+	virtual FileData* getEntryAt(int index) = 0;
 
 	virtual void resetLastCursor() = 0;
 
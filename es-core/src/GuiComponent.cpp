@@ -16,6 +16,7 @@
 #include "BindingManager.h"
 
 bool GuiComponent::isLaunchTransitionRunning = false;
+std::atomic<bool> GuiComponent::sFrameDamaged(true);
 
 GuiComponent::GuiComponent(Window* window) : mWindow(window), mParent(NULL), mOpacity(255), mAmbientOpacity(255),
 	mPosition(Vector3f::Zero()), mOrigin(Vector2f::Zero()), mRotationOrigin(0.5, 0.5), mScaleOrigin(0.5f, 0.5f), mSourceBounds(Vector4f::Zero()),
@@ -66,6 +67,8 @@ void GuiComponent::updateSelf(int deltaTime)
 {
 	if (mAnimationMap.size())
 	{
+		invalidateFrame();
+
 		for (auto it = mAnimationMap.cbegin(), next_it = it; it != mAnimationMap.cend(); it = next_it)
 		{
 			++next_it;
@@ -74,7 +77,12 @@ void GuiComponent::updateSelf(int deltaTime)
 	}
 
 	if (mStoryboardAnimator != nullptr)
+	{
+		if (mStoryboardAnimator->isRunning())
+			invalidateFrame();
+
 		mStoryboardAnimator->update(deltaTime);
+	}
 }
 
 void GuiComponent::updateChildren(int deltaTime)
@@ -143,6 +151,7 @@ void GuiComponent::setPosition(float x, float y, float z)
 		return;
 	
 	mPosition = position;
+	invalidateFrame();
 	onPositionChanged();	
 }
 
@@ -158,6 +167,7 @@ void GuiComponent::setOrigin(float x, float y)
 		return;
 
 	mOrigin = origin;
+	invalidateFrame();
 	onOriginChanged();
 }
 
@@ -173,6 +183,7 @@ void GuiComponent::setRotationOrigin(float x, float y)
 		return;
 
 	mRotationOrigin = origin;
+	invalidateFrame();
 	onRotationOriginChanged();
 }
 
@@ -189,6 +200,7 @@ void GuiComponent::setSize(float w, float h)
 	//	return;
 
 	mSize = size;
+	invalidateFrame();
     onSizeChanged();
 
 	auto clientSize = getClientRect();
@@ -205,6 +217,7 @@ void GuiComponent::setPadding(const Vector4f padding)
 	auto oldClientSize = getClientRect();
 
 	mPadding = padding;
+	invalidateFrame();
 	onPaddingChanged();
 
 	auto clientSize = getClientRect();
@@ -229,6 +242,7 @@ void GuiComponent::setRotation(float rotation)
 		return;
 
 	mRotation = rotation;
+	invalidateFrame();
 	onRotationChanged();
 }
 
@@ -243,6 +257,7 @@ void GuiComponent::setScale(float scale)
 		return;
 
 	mScale = scale;
+	invalidateFrame();
 	onScaleChanged();
 }
 
@@ -257,6 +272,7 @@ void GuiComponent::setScaleOrigin(const Vector2f& scaleOrigin)
 		return;
 
 	mScaleOrigin = scaleOrigin;
+	invalidateFrame();
 	onScaleOriginChanged();
 }
 
@@ -271,6 +287,7 @@ void GuiComponent::setScreenOffset(const Vector2f& screenOffset)
 		return;
 
 	mScreenOffset = screenOffset;
+	invalidateFrame();
 	onScreenOffsetChanged();
 }
 
@@ -285,6 +302,7 @@ void GuiComponent::setZIndex(float z)
 		return;
 
 	mZIndex = z;
+	invalidateFrame();
 
 	if (mParent != nullptr)
 		mParent->mChildZIndexDirty = true;
@@ -306,7 +324,11 @@ bool GuiComponent::isVisible() const
 }
 void GuiComponent::setVisible(bool visible)
 {
+	if (mVisible == visible)
+		return;
+
 	mVisible = visible;
+	invalidateFrame();
 }
 
 Vector2f GuiComponent::getCenter() const
@@ -319,6 +341,7 @@ Vector2f GuiComponent::getCenter() const
 void GuiComponent::addChild(GuiComponent* cmp)
 {
 	mChildren.push_back(cmp);
+	invalidateFrame();
 
 	if(cmp->getParent())
 		cmp->getParent()->removeChild(cmp);
@@ -338,6 +361,7 @@ void GuiComponent::removeChild(GuiComponent* cmp)
 	}
 
 	cmp->setParent(NULL);
+	invalidateFrame();
 
 	for(auto i = mChildren.cbegin(); i != mChildren.cend(); i++)
 	{
@@ -352,6 +376,7 @@ void GuiComponent::removeChild(GuiComponent* cmp)
 void GuiComponent::clearChildren()
 {
 	mChildren.clear();
+	invalidateFrame();
 }
 
 void GuiComponent::sortChildren()
@@ -402,6 +427,7 @@ void GuiComponent::setOpacity(unsigned char opacity)
 		return;
 
 	mOpacity = opacity;
+	invalidateFrame();
 	onOpacityChanged();
 
 	auto ambientOpacity = getOpacity();
@@ -415,6 +441,7 @@ void GuiComponent::setAmbientOpacity(unsigned char opacity)
 		return;
 
 	mAmbientOpacity = opacity;
+	invalidateFrame();
 	onOpacityChanged();
 
 	auto ambientOpacity = getOpacity();
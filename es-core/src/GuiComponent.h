@@ -10,6 +10,7 @@
 #include <functional>
 #include "ThemeData.h"
 #include <memory>
+#include <atomic>
 #include "anim/ThemeStoryboard.h"
 
 class Animation;
@@ -225,6 +226,10 @@ public:
 
 	std::map<std::string, ThemeStoryboard*>& getStoryBoards() { return mStoryBoards; };
 
+	// Damage tracking : anything changing what's displayed marks the frame dirty, so the Window can skip unchanged frames
+	static void		invalidateFrame() { sFrameDamaged = true; }
+	static bool		consumeFrameDamage() { return sFrameDamaged.exchange(false); }
+
 protected:
 	void			beginCustomClipRect();
 	void			endCustomClipRect();
@@ -278,6 +283,9 @@ public:
 	const static unsigned char MAX_ANIMATIONS = 4;
 	static bool isLaunchTransitionRunning;
 
+private:
+	static std::atomic<bool> sFrameDamaged;
+
 private:
 	std::string		mTag;
 	std::string		mClickAction;
@@ -5,6 +5,7 @@
 #include "Log.h"
 #include <assert.h>
 #include <thread>
+#include <time.h>
 
 #include <SDL.h>
 #include "Paths.h"
@@ -16,11 +17,239 @@
 #endif
 
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
 static std::mutex mMutex;
 
-CURLM* HttpReq::s_multi_handle = curl_multi_init();
+#ifdef CURL_AT_LEAST_VERSION
+#if CURL_AT_LEAST_VERSION(7,68,0)
+#define HTTP_REQ_REACTOR
+#endif
+#endif
+
+// Held by the network thread while it runs or waits for the transfers
+static std::mutex sMultiLock;
+static std::condition_variable sRequestCompleted;
+
+// Threads waiting for sMultiLock, the network thread doesn't take it back before they got it
+static std::mutex sMultiWaitersLock;
+static std::condition_variable sMultiWaitersDone;
+static int sMultiWaiters = 0;
+
+static std::thread* sReactor = nullptr;
+static std::atomic<bool> sReactorStopping(false);
+static std::once_flag sReactorStarted;
+
+#define HTTP_MAX_HOST_CONNECTIONS	6
+#define HTTP_MAX_CACHED_CONNECTIONS	32
+#define HTTP_HANDLE_POOL_SIZE		16
+#define HTTP_PARTIAL_FILE_MAX_AGE	(7 * 86400) // seconds, older partial downloads are not resumed
+
+static CURLM* createMultiHandle()
+{
+	CURLM* multi = curl_multi_init();
+	if (multi == nullptr)
+		return nullptr;
+
+#ifdef CURLPIPE_MULTIPLEX
+	// Requests to the same HTTP/2 server share a single connection
+	curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
+	curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)HTTP_MAX_HOST_CONNECTIONS);
+	curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, (long)HTTP_MAX_CACHED_CONNECTIONS);
+	return multi;
+}
+
+static std::mutex sShareLocks[CURL_LOCK_DATA_LAST];
+
+static void lockShare(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr)
+{
+	sShareLocks[data].lock();
+}
+
+static void unlockShare(CURL* handle, curl_lock_data data, void* userptr)
+{
+	sShareLocks[data].unlock();
+}
+
+static CURLSH* createShareHandle()
+{
+	CURLSH* share = curl_share_init();
+	if (share == nullptr)
+		return nullptr;
+
+	curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lockShare);
+	curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlockShare);
+	curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+	curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+	return share;
+}
+
+CURLM* HttpReq::s_multi_handle = createMultiHandle();
+CURLSH* HttpReq::s_share = createShareHandle();
 
 std::map<CURL*, HttpReq*> HttpReq::s_requests;
+std::function<void(const std::function<void()>&)> HttpReq::sUiThreadDispatcher;
+std::vector<CURL*> HttpReq::s_handlePool;
+
+CURL* HttpReq::acquireHandle()
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (!s_handlePool.empty())
+		{
+			CURL* handle = s_handlePool.back();
+			s_handlePool.pop_back();
+			return handle;
+		}
+	}
+
+	return curl_easy_init();
+}
+
+std::unique_lock<std::mutex> HttpReq::lockMultiHandle()
+{
+#ifdef HTTP_REQ_REACTOR
+	std::call_once(sReactorStarted, []() { sReactor = new std::thread(&HttpReq::runReactor); });
+
+	// Get the network thread out of curl_multi_poll : it lets the waiters go first
+	{
+		std::unique_lock<std::mutex> waitersLock(sMultiWaitersLock);
+		sMultiWaiters++;
+	}
+
+	curl_multi_wakeup(s_multi_handle);
+
+	std::unique_lock<std::mutex> lock(sMultiLock);
+
+	{
+		std::unique_lock<std::mutex> waitersLock(sMultiWaitersLock);
+		sMultiWaiters--;
+	}
+
+	sMultiWaitersDone.notify_all();
+	return lock;
+#else
+	return std::unique_lock<std::mutex>(sMultiLock);
+#endif
+}
+
+void HttpReq::runReactor()
+{
+#ifdef HTTP_REQ_REACTOR
+	while (!sReactorStopping)
+	{
+		{
+			std::unique_lock<std::mutex> multiLock(sMultiLock);
+
+			// sMultiLock keeps the requests alive, mMutex is only needed to publish their status
+			int handle_count;
+			CURLMcode merr = curl_multi_perform(s_multi_handle, &handle_count);
+			if (merr != CURLM_OK && merr != CURLM_CALL_MULTI_PERFORM)
+				LOG(LogError) << "HttpReq : curl_multi_perform failed : " << curl_multi_strerror(merr);
+
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				processMessages();
+			}
+
+			sRequestCompleted.notify_all();
+
+			if (sReactorStopping)
+				break;
+
+			int numfds = 0;
+			curl_multi_poll(s_multi_handle, nullptr, 0, 1000, &numfds);
+		}
+
+		std::unique_lock<std::mutex> waitersLock(sMultiWaitersLock);
+		sMultiWaitersDone.wait(waitersLock, []() { return sMultiWaiters == 0 || sReactorStopping; });
+	}
+#endif
+}
+
+void HttpReq::shutdown()
+{
+	if (sReactor == nullptr)
+		return;
+
+	{
+		std::unique_lock<std::mutex> waitersLock(sMultiWaitersLock);
+		sReactorStopping = true;
+	}
+
+	sMultiWaitersDone.notify_all();
+#ifdef HTTP_REQ_REACTOR
+	curl_multi_wakeup(s_multi_handle);
+#endif
+
+	sReactor->join();
+	delete sReactor;
+	sReactor = nullptr;
+
+	sRequestCompleted.notify_all();
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	sUiThreadDispatcher = nullptr;
+}
+
+void HttpReq::setUiThreadDispatcher(const std::function<void(const std::function<void()>&)>& dispatcher)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	sUiThreadDispatcher = dispatcher;
+}
+
+bool HttpReq::setOnCompleted(const std::function<void(HttpReq*)>& callback)
+{
+#ifdef HTTP_REQ_REACTOR
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (!sUiThreadDispatcher || sReactorStopping)
+		return false;
+
+	mOnCompleted = callback;
+
+	if (mStatus != REQ_IN_PROGRESS)
+		notifyCompleted();
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+// mMutex must be locked
+void HttpReq::notifyCompleted()
+{
+	if (!mOnCompleted || !sUiThreadDispatcher)
+		return;
+
+	auto token = mCompletionToken;
+	auto callback = mOnCompleted;
+	mOnCompleted = nullptr;
+
+	sUiThreadDispatcher([token, callback]()
+	{
+		std::unique_lock<std::mutex> lock(token->lock);
+		if (token->request != nullptr)
+			callback(token->request);
+	});
+}
+
+// mMutex must be locked
+void HttpReq::releaseHandle(CURL* handle, bool usesCookieManager)
+{
+	// The cookie jar is only written by curl_easy_cleanup
+	if (usesCookieManager || s_handlePool.size() >= HTTP_HANDLE_POOL_SIZE)
+	{
+		curl_easy_cleanup(handle);
+		return;
+	}
+
+	// curl_easy_reset keeps the cookies in memory : don't send them with the next request
+	curl_easy_setopt(handle, CURLOPT_COOKIELIST, "ALL");
+	curl_easy_reset(handle);
+	s_handlePool.push_back(handle);
+}
 
 std::string HttpReq::urlEncode(const std::string &s)
 {
@@ -109,7 +338,7 @@ void HttpReq::resetCookies()
 }
 
 HttpReq::HttpReq(const std::string& url, const std::string& outputFilename) 
-	: mStatus(REQ_IN_PROGRESS), mHandle(NULL), mFile(NULL)
+	: mStatus(REQ_IN_PROGRESS), mHandle(NULL), mHeaders(NULL), mFile(NULL), mUsesCookieManager(false)
 {
 	HttpReqOptions options;
 	options.outputFilename = outputFilename;	
@@ -117,7 +346,7 @@ HttpReq::HttpReq(const std::string& url, const std::string& outputFilename)
 }
 
 HttpReq::HttpReq(const std::string& url, HttpReqOptions* options)
-	: mStatus(REQ_IN_PROGRESS), mHandle(NULL), mFile(NULL)
+	: mStatus(REQ_IN_PROGRESS), mHandle(NULL), mHeaders(NULL), mFile(NULL), mUsesCookieManager(false)
 {
 	performRequest(url, options);
 }
@@ -134,7 +363,15 @@ void HttpReq::performRequest(const std::string& url, HttpReqOptions* options)
 	mFilePath = outputFilename;
 	mPosition = -1;
 	mPercent = -1;	
-	mHandle = curl_easy_init();
+	mResumable = options != nullptr && options->resumeDownload && !outputFilename.empty();
+	mResumePending = false;
+	mValidatorPending = false;
+	mTransferInterrupted = false;
+	mStreamError = false;
+	mResumeFrom = 0;
+	mCompletionToken = std::make_shared<CompletionToken>();
+	mCompletionToken->request = this;
+	mHandle = acquireHandle();
 
 	if(mHandle == NULL)
 	{
@@ -143,6 +380,15 @@ void HttpReq::performRequest(const std::string& url, HttpReqOptions* options)
 		return;
 	}
 
+	if (s_share != nullptr)
+		curl_easy_setopt(mHandle, CURLOPT_SHARE, s_share);
+
+#ifdef CURLPIPE_MULTIPLEX
+	// Prefer waiting for a connection which can multiplex over opening a new one
+	curl_easy_setopt(mHandle, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+	curl_easy_setopt(mHandle, CURLOPT_PIPEWAIT, 1L);
+#endif
+
 	//set the url
 	CURLcode err = curl_easy_setopt(mHandle, CURLOPT_URL, url.c_str());
 	if(err != CURLE_OK)
@@ -171,12 +417,10 @@ void HttpReq::performRequest(const std::string& url, HttpReqOptions* options)
 
 	if (options != nullptr && options->customHeaders.size() > 0)
 	{
-		struct curl_slist *hs = nullptr;
-
 		for (auto header : options->customHeaders)
-			hs = curl_slist_append(hs, header.c_str());
+			mHeaders = curl_slist_append(mHeaders, header.c_str());
 
-		curl_easy_setopt(mHandle, CURLOPT_HTTPHEADER, hs);
+		curl_easy_setopt(mHandle, CURLOPT_HTTPHEADER, mHeaders);
 	}
 
 	//set curl to handle redirects
@@ -268,6 +512,7 @@ void HttpReq::performRequest(const std::string& url, HttpReqOptions* options)
 
 		curl_easy_setopt(mHandle, CURLOPT_COOKIEFILE, cookiesFile.c_str());
 		curl_easy_setopt(mHandle, CURLOPT_COOKIEJAR, cookiesFile.c_str());
+		mUsesCookieManager = true;
 	}
 
 	curl_easy_setopt(mHandle, CURLOPT_HEADERFUNCTION, &HttpReq::header_callback);
@@ -301,18 +546,37 @@ void HttpReq::performRequest(const std::string& url, HttpReqOptions* options)
 	}
 #endif
 	
+	auto multiLock = lockMultiHandle();
 	std::unique_lock<std::mutex> lock(mMutex);
 
 	if (!mFilePath.empty())
 	{
 		mTempStreamPath = outputFilename + ".tmp";
-		
-		Utils::FileSystem::removeFile(mTempStreamPath);
+
+		// Continue the partial file of an interrupted download, only if the server can tell it's still the same file
+		std::string validator;
+		if (mResumable && Utils::FileSystem::exists(mTempStreamPath, false))
+		{
+			std::string validatorPath = mTempStreamPath + ".info";
+			if (Utils::FileSystem::exists(validatorPath))
+				validator = Utils::String::trim(Utils::FileSystem::readAllText(validatorPath));
+
+			time_t age = time(nullptr) - Utils::FileSystem::getFileModificationDate(mTempStreamPath).getTime();
+			if (!validator.empty() && age < HTTP_PARTIAL_FILE_MAX_AGE)
+				mResumeFrom = (int64_t)Utils::FileSystem::getFileSize(mTempStreamPath);
+		}
+
+		if (mResumeFrom <= 0)
+		{
+			mResumeFrom = 0;
+			Utils::FileSystem::removeFile(mTempStreamPath);
+			Utils::FileSystem::removeFile(mTempStreamPath + ".info");
+		}
 
 #if defined(_WIN32)
-		mFile = _wfopen(Utils::String::convertToWideString(mTempStreamPath).c_str(), L"wb");
+		mFile = _wfopen(Utils::String::convertToWideString(mTempStreamPath).c_str(), mResumeFrom > 0 ? L"ab" : L"wb");
 #else
-		mFile = fopen(mTempStreamPath.c_str(), "wb");		
+		mFile = fopen(mTempStreamPath.c_str(), mResumeFrom > 0 ? "ab" : "wb");		
 #endif
 
 		if (mFile == nullptr)
@@ -322,7 +586,21 @@ void HttpReq::performRequest(const std::string& url, HttpReqOptions* options)
 			return;
 		}
 
-		mPosition = 0;
+		if (mResumeFrom > 0)
+		{
+			LOG(LogDebug) << "HttpReq : resuming " << url << " from " << mResumeFrom;
+
+			// If the file has changed since, the server ignores the range & sends it whole
+			mHeaders = curl_slist_append(mHeaders, ("If-Range: " + validator).c_str());
+			curl_easy_setopt(mHandle, CURLOPT_HTTPHEADER, mHeaders);
+
+			curl_easy_setopt(mHandle, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)mResumeFrom);
+			mResumePending = true;
+		}
+
+		mValidatorPending = mResumable;
+
+		mPosition = mResumeFrom;
 		Utils::FileSystem::removeFile(outputFilename);
 	}
 
@@ -352,11 +630,21 @@ void HttpReq::closeStream()
 
 HttpReq::~HttpReq()
 {
+	// A completion posted to the UI thread must not use this request anymore
+	{
+		std::unique_lock<std::mutex> tokenLock(mCompletionToken->lock);
+		mCompletionToken->request = nullptr;
+	}
+
+	auto multiLock = lockMultiHandle();
 	std::unique_lock<std::mutex> lock(mMutex);
 
 	closeStream();
 	
-	if (!mTempStreamPath.empty())
+	// Keep the partial file of a resumable download which didn't complete
+	bool keepPartialFile = mResumable && (mStatus == REQ_IN_PROGRESS || mTransferInterrupted);
+
+	if (!mTempStreamPath.empty() && !keepPartialFile)
 		Utils::FileSystem::removeFile(mTempStreamPath);
 
 	if(mHandle)
@@ -366,18 +654,25 @@ HttpReq::~HttpReq()
 		CURLMcode merr = curl_multi_remove_handle(s_multi_handle, mHandle);
 
 		if(merr != CURLM_OK)
+		{
 			LOG(LogError) << "Error removing curl_easy handle from curl_multi: " << curl_multi_strerror(merr);
-
-		curl_easy_cleanup(mHandle);
+			curl_easy_cleanup(mHandle);
+		}
+		else
+			releaseHandle(mHandle, mUsesCookieManager);
 	}
+
+	if (mHeaders != nullptr)
+		curl_slist_free_all(mHeaders);
 }
 
 HttpReq::Status HttpReq::status()
 {
+	std::unique_lock<std::mutex> lock(mMutex);
+
+#ifndef HTTP_REQ_REACTOR
 	if (mStatus == REQ_IN_PROGRESS)
 	{
-		std::unique_lock<std::mutex> lock(mMutex);
-
 		int handle_count;
 		CURLMcode merr = curl_multi_perform(s_multi_handle, &handle_count);
 		if (merr != CURLM_OK && merr != CURLM_CALL_MULTI_PERFORM)
@@ -389,123 +684,140 @@ HttpReq::Status HttpReq::status()
 			return mStatus;
 		}
 
-		int msgs_left;
-		CURLMsg* msg;
-		while ((msg = curl_multi_info_read(s_multi_handle, &msgs_left)) != nullptr)
+		processMessages();
+	}
+#endif
+
+	return mStatus;
+}
+
+// mMutex must be locked
+void HttpReq::processMessages()
+{
+	int msgs_left;
+	CURLMsg* msg;
+	while ((msg = curl_multi_info_read(s_multi_handle, &msgs_left)) != nullptr)
+	{
+		if (msg->msg == CURLMSG_DONE)
 		{
-			if (msg->msg == CURLMSG_DONE)
+			HttpReq* req = s_requests[msg->easy_handle];
+			if (req == NULL)
 			{
-				HttpReq* req = s_requests[msg->easy_handle];
-				if (req == NULL)
-				{
-					LOG(LogError) << "Cannot find easy handle!";
-					continue;
-				}
+				LOG(LogError) << "Cannot find easy handle!";
+				continue;
+			}
 
-				req->closeStream();
+			req->closeStream();
 
-				if (req->mStatus == REQ_FILESTREAM_ERROR)
-				{
-					std::string err = "File stream error (disk full ?)";
-					req->onError(err.c_str());
-				}
-				else if (msg->data.result == CURLE_OK)
+			if (req->mStreamError)
+			{
+				req->mStatus = REQ_FILESTREAM_ERROR;
+
+				std::string err = "File stream error (disk full ?)";
+				req->onError(err.c_str());
+			}
+			else if (msg->data.result == CURLE_OK)
+			{
+				int http_status_code;
+				curl_easy_getinfo(msg->easy_handle, CURLINFO_RESPONSE_CODE, &http_status_code);					
+
+				if (http_status_code == 304)
+					req->mStatus = REQ_304_NOTMODIFIED;
+				else if (http_status_code < 200 || http_status_code > 299)
 				{
-					int http_status_code;
-					curl_easy_getinfo(msg->easy_handle, CURLINFO_RESPONSE_CODE, &http_status_code);					
+					std::string err;
 
-					if (http_status_code < 200 || http_status_code > 299)
+					if (http_status_code >= 400 && http_status_code <= 503)
 					{
-						std::string err;
-
-						if (http_status_code >= 400 && http_status_code <= 503)
+						if (req->mFilePath.empty())
 						{
-							if (req->mFilePath.empty())
+							auto content = req->getContent();
+							if (!content.empty() && content.find("<body") != std::string::npos)
 							{
-								auto content = req->getContent();
-								if (!content.empty() && content.find("<body") != std::string::npos)
-								{
-									// Parse response HTML & extract body
-									auto body = Utils::String::extractString(content, "<body", "</body>", true);
-									body = Utils::String::replace(body, "\r", "");
-									body = Utils::String::replace(body, "\n", "");
-									body = Utils::String::replace(body, "</p>", "\r\n");
-									body = Utils::String::replace(body, "<br>", "\r\n");
-									body = Utils::String::replace(body, "<hr>", "\r\n");
-									body = Utils::String::removeHtmlTags(body);
-
-									if (!body.empty())
-										err = "HTTP status " + std::to_string(http_status_code) + "\r\n" + body;
-								}
-								else
-									err = content;
+								// Parse response HTML & extract body
+								auto body = Utils::String::extractString(content, "<body", "</body>", true);
+								body = Utils::String::replace(body, "\r", "");
+								body = Utils::String::replace(body, "\n", "");
+								body = Utils::String::replace(body, "</p>", "\r\n");
+								body = Utils::String::replace(body, "<br>", "\r\n");
+								body = Utils::String::replace(body, "<hr>", "\r\n");
+								body = Utils::String::removeHtmlTags(body);
+
+								if (!body.empty())
+									err = "HTTP status " + std::to_string(http_status_code) + "\r\n" + body;
 							}
-
-							if (http_status_code > 500)
-								req->mStatus = REQ_IO_ERROR;
 							else
-								req->mStatus = (Status)http_status_code;
-						}						
-						else
+								err = content;
+						}
+
+						if (http_status_code > 500)
 							req->mStatus = REQ_IO_ERROR;
+						else
+							req->mStatus = (Status)http_status_code;
+					}						
+					else
+						req->mStatus = REQ_IO_ERROR;
 
-						if (err.empty())
-							err = "HTTP status " + std::to_string(http_status_code);
+					if (err.empty())
+						err = "HTTP status " + std::to_string(http_status_code);
 
-						req->onError(err.c_str());
-					}
-					else
+					req->onError(err.c_str());
+				}
+				else
+				{
+					if (!req->mFilePath.empty())
 					{
-						if (!req->mFilePath.empty())
-						{
-							bool renamed = Utils::FileSystem::renameFile(req->mTempStreamPath.c_str(), req->mFilePath.c_str());
+						bool renamed = Utils::FileSystem::renameFile(req->mTempStreamPath.c_str(), req->mFilePath.c_str());
 #if WIN32
-							if (renamed)
+						if (renamed)
+						{
+							auto wfn = Utils::String::convertToWideString(req->mFilePath);
+							HANDLE hFile = CreateFileW(wfn.c_str(), GENERIC_WRITE, FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
+							if (hFile != INVALID_HANDLE_VALUE)
 							{
-								auto wfn = Utils::String::convertToWideString(req->mFilePath);
-								HANDLE hFile = CreateFileW(wfn.c_str(), GENERIC_WRITE, FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
-								if (hFile != INVALID_HANDLE_VALUE)
-								{
-									SYSTEMTIME st;
-									GetSystemTime(&st);              // Gets the current system time
-									FILETIME ft;
-									SystemTimeToFileTime(&st, &ft);  // Converts the current system time to file time format
-
-									SetFileTime(hFile, &ft, &ft, &ft);
-									CloseHandle(hFile);
-								}
+								SYSTEMTIME st;
+								GetSystemTime(&st);              // Gets the current system time
+								FILETIME ft;
+								SystemTimeToFileTime(&st, &ft);  // Converts the current system time to file time format
+
+								SetFileTime(hFile, &ft, &ft, &ft);
+								CloseHandle(hFile);
 							}
+						}
 #endif
-							if (!renamed)
-							{
-								// Strange behaviour on Windows : sometimes std::rename fails if it's done too early after closing stream
-								// Copy file instead & try to delete it
-								if (Utils::FileSystem::copyFile(req->mTempStreamPath, req->mFilePath))
-									renamed = true;
-							}
+						if (!renamed)
+						{
+							// Strange behaviour on Windows : sometimes std::rename fails if it's done too early after closing stream
+							// Copy file instead & try to delete it
+							if (Utils::FileSystem::copyFile(req->mTempStreamPath, req->mFilePath))
+								renamed = true;
+						}
 
-							if (renamed)
-								req->mStatus = REQ_SUCCESS;
-							else
-							{
-								req->mStatus = REQ_IO_ERROR;
-								req->onError("file rename failed");
-							}
+						if (renamed)
+						{
+							Utils::FileSystem::removeFile(req->mTempStreamPath + ".info");
+							req->mStatus = REQ_SUCCESS;
 						}
 						else
-							req->mStatus = REQ_SUCCESS;
+						{
+							req->mStatus = REQ_IO_ERROR;
+							req->onError("file rename failed");
+						}
 					}
-				}
-				else
-				{
-					req->mStatus = REQ_IO_ERROR;
-					req->onError(curl_easy_strerror(msg->data.result));
+					else
+						req->mStatus = REQ_SUCCESS;
 				}
 			}
+			else
+			{
+				req->mStatus = REQ_IO_ERROR;
+				req->mTransferInterrupted = true;
+				req->onError(curl_easy_strerror(msg->data.result));
+			}
+
+			req->notifyCompleted();
 		}
 	}
-
-	return mStatus;
 }
 
 std::string HttpReq::getContent() 
@@ -558,6 +870,27 @@ std::string HttpReq::getResponseHeader(const std::string& header)
 	return "";
 }
 
+// The ETag, or the date if the ETag is weak : If-Range only accepts strong validators
+std::string HttpReq::getValidator()
+{
+	std::string etag;
+	std::string lastModified;
+
+	for (auto header : mResponseHeaders)
+	{
+		std::string name = Utils::String::toLower(header.first);
+		if (name == "etag")
+			etag = header.second;
+		else if (name == "last-modified")
+			lastModified = header.second;
+	}
+
+	if (!etag.empty() && !Utils::String::startsWith(etag, "W/"))
+		return etag;
+
+	return lastModified;
+}
+
 size_t HttpReq::header_callback(char *buffer, size_t size, size_t nitems, void *userdata)
 {
 	HttpReq* request = ((HttpReq*)userdata);
@@ -588,6 +921,39 @@ size_t HttpReq::write_content(void* buff, size_t size, size_t nmemb, void* req_p
 		return size * nmemb;
 	}
 
+	if (request->mResumePending || request->mValidatorPending)
+	{
+		long http_status_code = 0;
+		curl_easy_getinfo(request->mHandle, CURLINFO_RESPONSE_CODE, &http_status_code);
+
+		// Remember which version of the file is downloaded, a partial file without validator is never resumed
+		if (request->mValidatorPending && http_status_code >= 200 && http_status_code < 300 && http_status_code != 206)
+		{
+			std::string validator = request->getValidator();
+			if (validator.empty())
+				Utils::FileSystem::removeFile(request->mTempStreamPath + ".info");
+			else
+				Utils::FileSystem::writeAllText(request->mTempStreamPath + ".info", validator);
+		}
+
+		request->mValidatorPending = false;
+
+		// The server ignored the range : the response is the whole file, start it over
+		if (request->mResumePending && http_status_code != 206)
+		{
+			request->closeStream();
+#if defined(_WIN32)
+			request->mFile = _wfopen(Utils::String::convertToWideString(request->mTempStreamPath).c_str(), L"wb");
+#else
+			request->mFile = fopen(request->mTempStreamPath.c_str(), "wb");
+#endif
+			request->mResumeFrom = 0;
+			request->mPosition = 0;
+		}
+
+		request->mResumePending = false;
+	}
+
 	FILE* file = request->mFile;
 	if (file == nullptr)
 		return 0;
@@ -597,7 +963,7 @@ size_t HttpReq::write_content(void* buff, size_t size, size_t nmemb, void* req_p
 	if (ferror(file))
 	{
 		request->closeStream();			
-		request->mStatus = REQ_FILESTREAM_ERROR;
+		request->mStreamError = true;
 		request->mErrorMsg = "IO ERROR (DISK FULL?)";		
 
 		return 0;
@@ -608,10 +974,11 @@ size_t HttpReq::write_content(void* buff, size_t size, size_t nmemb, void* req_p
 	{
 		request->mPosition += rs;
 
+		// With a range request, the content length is what remains to download
 		if (cl <= 0)
 			request->mPercent = -1;
 		else
-			request->mPercent = (int)(request->mPosition * 100LL / cl);
+			request->mPercent = (int)(request->mPosition * 100LL / (cl + request->mResumeFrom));
 	}
 
 	return nmemb;
@@ -619,8 +986,14 @@ size_t HttpReq::write_content(void* buff, size_t size, size_t nmemb, void* req_p
 
 bool HttpReq::wait()
 {
+#ifdef HTTP_REQ_REACTOR
+	std::unique_lock<std::mutex> lock(mMutex);
+	sRequestCompleted.wait(lock, [this]() { return mStatus != REQ_IN_PROGRESS || sReactorStopping; });
+	return mStatus == REQ_SUCCESS;
+#else
 	while (status() == HttpReq::REQ_IN_PROGRESS)
 		std::this_thread::sleep_for(std::chrono::milliseconds(20));
 
 	return status() == HttpReq::REQ_SUCCESS;
+#endif
 }
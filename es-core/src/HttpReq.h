@@ -3,7 +3,10 @@
 #define ES_CORE_HTTP_REQ_H
 
 #include <curl/curl.h>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <fstream>
 #include <string>
@@ -50,6 +53,7 @@ public:
 		userAgent = HTTP_REQ_USERAGENT;
 		useCookieManager = true;
 		connectTimeout = 10000L;
+		resumeDownload = false;
 	}
 
 	HttpReqOptions(const std::string& filename)
@@ -58,6 +62,7 @@ public:
 		userAgent = HTTP_REQ_USERAGENT;
 		useCookieManager = true;
 		connectTimeout = 10000L;
+		resumeDownload = false;
 	}
 
 	std::string outputFilename;
@@ -66,6 +71,9 @@ public:
 	std::string userAgent;
     long connectTimeout;
 	bool useCookieManager;
+
+	// File mode : an interrupted download keeps its partial file, and the next request continues it with a range request
+	bool resumeDownload;
 };
 
 class HttpReq
@@ -83,6 +91,7 @@ public:
 		REQ_FILESTREAM_ERROR = 4,		
 
 		REQ_SUCCESS = 200,
+		REQ_304_NOTMODIFIED = 304, // Only when the request has a "If-None-Match" header
 		REQ_400_BADREQUEST = 400,
 		REQ_401_FORBIDDEN = 401,
 		REQ_403_BADLOGIN = 403,
@@ -118,8 +127,18 @@ public:
 
 	bool wait();
 
+	// The callback is called on the UI thread once the request has completed, unless the request is deleted before.
+	// Returns false if completions can't be notified (no network thread or no UI thread dispatcher) : status() must be polled
+	bool setOnCompleted(const std::function<void(HttpReq*)>& callback);
+
+	// Runs a function on the UI thread, ex : Window::postToUiThread
+	static void setUiThreadDispatcher(const std::function<void(const std::function<void()>&)>& dispatcher);
+
 	static void resetCookies();
 
+	// Stops the network thread, the pending requests won't complete anymore
+	static void shutdown();
+
 private:
 	void performRequest(const std::string& url, HttpReqOptions* options);
 	void closeStream();
@@ -135,9 +154,42 @@ private:
 
 	static CURLM* s_multi_handle;
 
+	// DNS & TLS sessions shared by all the requests. The connections are kept in the multi handle cache
+	static CURLSH* s_share;
+
+	// Reset easy handles : they keep their connection state. Handles using the cookie jar are not pooled, they save it when cleaned up
+	static std::vector<CURL*> s_handlePool;
+
+	static CURL* acquireHandle();
+	static void releaseHandle(CURL* handle, bool usesCookieManager);
+
+	static void processMessages();
+
+	// With curl 7.68+, a network thread runs the transfers & sleeps in curl_multi_poll : status() only reads the state.
+	// Other threads must hold this lock to use the multi handle
+	static std::unique_lock<std::mutex> lockMultiHandle();
+	static void runReactor();
+
 	void onError(const char* msg);
+	std::string getValidator();
+
+	// mMutex must be locked
+	void notifyCompleted();
+
+	// Shared with the posted completion : it's cleared when the request is deleted
+	struct CompletionToken
+	{
+		std::mutex lock;
+		HttpReq* request;
+	};
+
+	std::shared_ptr<CompletionToken> mCompletionToken;
+	std::function<void(HttpReq*)> mOnCompleted;
+
+	static std::function<void(const std::function<void()>&)> sUiThreadDispatcher;
 
 	CURL* mHandle;
+	struct curl_slist* mHeaders;
 
 	Status mStatus;
 
@@ -149,6 +201,15 @@ private:
 	std::string   mTempStreamPath;	
 	FILE*		  mFile;	
 
+	bool		  mUsesCookieManager;
+
+	bool		  mResumable;
+	bool		  mResumePending;
+	bool		  mValidatorPending;
+	bool		  mTransferInterrupted;
+	bool		  mStreamError; // Set by write_content, turned into REQ_FILESTREAM_ERROR by processMessages
+	int64_t		  mResumeFrom;
+
 	std::string mErrorMsg;
 	std::string mUrl;
 
@@ -222,6 +222,42 @@ void ImageIO::flipPixelsVert(unsigned char* imagePx, const size_t& width, const
 	}
 }
 
+static inline unsigned char clampColor(int value)
+{
+	return value < 0 ? 0 : (value > 255 ? 255 : (unsigned char)value);
+}
+
+void ImageIO::convertI420ToRGBA(const unsigned char* planes, const size_t& width, const size_t& height, unsigned char* dataRGBA)
+{
+	// Same BT.601 limited range coefficients as the renderer's YUV shader, in 8.8 fixed point
+	const size_t chromaWidth = width / 2;
+
+	const unsigned char* yPlane = planes;
+	const unsigned char* uPlane = yPlane + width * height;
+	const unsigned char* vPlane = uPlane + chromaWidth * (height / 2);
+
+	for (size_t y = 0; y < height; y++)
+	{
+		const unsigned char* yRow = yPlane + y * width;
+		const unsigned char* uRow = uPlane + (y / 2) * chromaWidth;
+		const unsigned char* vRow = vPlane + (y / 2) * chromaWidth;
+		unsigned char* dst = dataRGBA + y * width * 4;
+
+		for (size_t x = 0; x < width; x++)
+		{
+			int c = 298 * ((int)yRow[x] - 16) + 128;
+			int d = (int)uRow[x / 2] - 128;
+			int e = (int)vRow[x / 2] - 128;
+
+			dst[0] = clampColor((c + 409 * e) >> 8);
+			dst[1] = clampColor((c - 100 * d - 208 * e) >> 8);
+			dst[2] = clampColor((c + 516 * d) >> 8);
+			dst[3] = 255;
+			dst += 4;
+		}
+	}
+}
+
 Vector2f ImageIO::adjustPictureSizeF(Vector2f imageSize, Vector2f maxSize, bool externSize)
 {
 	return adjustPictureSizeF(imageSize.x(), imageSize.y(), maxSize.x(), maxSize.y(), externSize);
@@ -41,6 +41,9 @@ class ImageIO
 public:
 	static unsigned char*  loadFromMemoryRGBA32(const unsigned char * data, const size_t size, size_t & width, size_t & height, MaxSizeInfo* maxSize = nullptr, Vector2i* baseSize = nullptr, Vector2i* packedSize = nullptr, int subImageIndex = -1);
 	static void flipPixelsVert(unsigned char* imagePx, const size_t& width, const size_t& height);
+
+	// planes : I420 frame, Y plane followed by the U & V planes at half resolution. width & height must be even.
+	static void convertI420ToRGBA(const unsigned char* planes, const size_t& width, const size_t& height, unsigned char* dataRGBA);
 	
 	static Vector2f getPictureMinSize(Vector2f imageSize, Vector2f maxSize);
 	
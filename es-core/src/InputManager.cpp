@@ -52,7 +52,7 @@ static std::mutex mJoysticksLock;
 InputManager* InputManager::mInstance = NULL;
 Delegate<IJoystickChangedEvent> InputManager::joystickChanged;
 
-InputManager::InputManager() : mKeyboardInputConfig(nullptr), mMouseButtonsInputConfig(nullptr), mCECInputConfig(nullptr), mGunInputConfig(nullptr), mGunManager(nullptr)
+InputManager::InputManager() : mKeyboardInputConfig(nullptr), mMouseButtonsInputConfig(nullptr), mCECInputConfig(nullptr), mGunInputConfig(nullptr), mGunManager(nullptr), mEmulatorsCommandValid(false), mEmulatorsCommandGeneration(0)
 {
 
 }
@@ -223,6 +223,9 @@ void InputManager::clearJoysticks()
 
 	mJoysticks.clear();
 
+	mEmulatorsCommandValid = false;
+	mEmulatorsCommandGeneration++;
+
 	for (auto iter = mInputConfigs.begin(); iter != mInputConfigs.end(); iter++)
 		if (iter->second)
 			delete iter->second;
@@ -1073,6 +1076,8 @@ void InputManager::writeDeviceConfig(InputConfig* config)
 	// execute any onFinish commands and re-load the config for changes
 	doOnFinish();
 	loadInputConfig(config);
+
+	invalidateEmulatorsCommand();
 }
 
 void InputManager::doOnFinish()
@@ -1156,6 +1161,9 @@ int InputManager::getNumConfiguredDevices()
 
 void InputManager::computeLastKnownPlayersDeviceIndexes() 
 {
+	// Called when the devices or the players assignments have changed
+	invalidateEmulatorsCommand();
+
 	std::map<int, InputConfig*> playerJoysticks = computePlayersConfigs();
 
 	m_lastKnownPlayersDeviceIndexes.clear();
@@ -1294,7 +1302,24 @@ std::map<int, InputConfig*> InputManager::computePlayersConfigs()
 	return playerJoysticks;
 }
 
+void InputManager::invalidateEmulatorsCommand()
+{
+	std::unique_lock<std::mutex> lock(mJoysticksLock);
+	mEmulatorsCommandValid = false;
+	mEmulatorsCommandGeneration++;
+}
+
 std::string InputManager::configureEmulators() {
+  unsigned int generation;
+
+  {
+	  std::unique_lock<std::mutex> lock(mJoysticksLock);
+	  if (mEmulatorsCommandValid)
+		  return mEmulatorsCommand;
+
+	  generation = mEmulatorsCommandGeneration;
+  }
+
   std::map<int, InputConfig*> playerJoysticks = computePlayersConfigs();
   std::stringstream command;
 
@@ -1314,6 +1339,17 @@ std::string InputManager::configureEmulators() {
     }
   }
   LOG(LogInfo) << "Configure emulators command : " << command.str().c_str();
+
+  {
+	  // Not kept if the devices have changed meanwhile
+	  std::unique_lock<std::mutex> lock(mJoysticksLock);
+	  if (generation == mEmulatorsCommandGeneration)
+	  {
+		  mEmulatorsCommand = command.str();
+		  mEmulatorsCommandValid = true;
+	  }
+  }
+
   return command.str();
 }
 
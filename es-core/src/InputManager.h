@@ -56,6 +56,7 @@ public:
 	// this list helps to convert mice to guns
 	std::vector<std::string> getMice();
 
+	// Kept until the devices or the players assignments change
 	std::string configureEmulators();
 
 	// information about last association players/pads 
@@ -96,6 +97,11 @@ private:
 	std::map<int, PlayerDeviceInfo> m_lastKnownPlayersDeviceIndexes;
 	std::map<int, InputConfig*> computePlayersConfigs();
 
+	std::string  mEmulatorsCommand;
+	bool		 mEmulatorsCommandValid;
+	unsigned int mEmulatorsCommandGeneration;
+	void invalidateEmulatorsCommand();
+
 	bool initialized() const;
 	bool loadInputConfig(InputConfig* config); // returns true if successfully loaded, false if not (or didn't exist)
 	bool loadFromSdlMapping(InputConfig* config, const std::string& mapping);
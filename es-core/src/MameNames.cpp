@@ -5,6 +5,7 @@
 #include "Log.h"
 #include <pugixml/src/pugixml.hpp>
 #include "utils/StringUtil.h"
+#include <algorithm>
 #include <string.h>
 
 MameNames* MameNames::sInstance = nullptr;
@@ -35,19 +36,100 @@ MameNames* MameNames::getInstance()
 
 } // getInstance
 
-static ArcadeRomType& operator |=(ArcadeRomType& a, ArcadeRomType b)
+#define INPUT_FLAGS	((unsigned int)ArcadeRomType::LIGHTGUN | (unsigned int)ArcadeRomType::WHEEL | (unsigned int)ArcadeRomType::TRACKBALL | (unsigned int)ArcadeRomType::SPINNER)
+
+static unsigned int hashName(const char* name, size_t length)
 {
-	unsigned ai = static_cast<unsigned>(a);
-	unsigned bi = static_cast<unsigned>(b);
-	ai |= bi;
-	return a = static_cast<ArcadeRomType>(ai);
+	// FNV-1a
+	unsigned int hash = 2166136261u;
+	for (size_t i = 0; i < length; i++)
+	{
+		hash ^= (unsigned char)name[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
 }
 
-static bool hasFlag(ArcadeRomType& a, ArcadeRomType b)
+MameNames::NameTable::NameTable() : mCount(0)
 {
-	unsigned ai = static_cast<unsigned>(a);
-	unsigned bi = static_cast<unsigned>(b);
-	return (ai & bi) == bi;
+
+}
+
+MameNames::NameTable::Entry* MameNames::NameTable::find(const char* name, size_t length)
+{
+	if (mEntries.empty())
+		return nullptr;
+
+	unsigned int hash = hashName(name, length);
+	size_t mask = mEntries.size() - 1;
+
+	for (size_t i = hash & mask; mEntries[i].name != 0; i = (i + 1) & mask)
+	{
+		Entry& entry = mEntries[i];
+		if (entry.hash != hash)
+			continue;
+
+		const char* entryName = getString(entry.name);
+		if (strncmp(entryName, name, length) == 0 && entryName[length] == 0)
+			return &entry;
+	}
+
+	return nullptr;
+}
+
+MameNames::NameTable::Entry& MameNames::NameTable::insert(const std::string& name)
+{
+	auto existing = find(name.c_str(), name.size());
+	if (existing != nullptr)
+		return *existing;
+
+	// Keep the table half empty, so the probes stay short
+	if ((mCount + 1) * 2 > mEntries.size())
+		grow();
+
+	unsigned int hash = hashName(name.c_str(), name.size());
+	size_t mask = mEntries.size() - 1;
+
+	size_t i = hash & mask;
+	while (mEntries[i].name != 0)
+		i = (i + 1) & mask;
+
+	Entry& entry = mEntries[i];
+	entry.hash = hash;
+	entry.name = addString(name);
+	entry.displayName = 0;
+	entry.flags = 0;
+
+	mCount++;
+	return entry;
+}
+
+unsigned int MameNames::NameTable::addString(const std::string& value)
+{
+	unsigned int offset = (unsigned int)mStrings.size() + 1;
+	mStrings.append(value.c_str(), value.size() + 1);
+	return offset;
+}
+
+void MameNames::NameTable::grow()
+{
+	std::vector<Entry> entries(std::max((size_t)1024, mEntries.size() * 2), Entry { 0, 0, 0, 0 });
+	size_t mask = entries.size() - 1;
+
+	for (auto& entry : mEntries)
+	{
+		if (entry.name == 0)
+			continue;
+
+		size_t i = entry.hash & mask;
+		while (entries[i].name != 0)
+			i = (i + 1) & mask;
+
+		entries[i] = entry;
+	}
+
+	mEntries.swap(entries);
 }
 
 MameNames::MameNames()
@@ -69,7 +151,6 @@ MameNames::MameNames()
 			pugi::xml_node games = doc.child("roms");
 			if (games)
 			{
-				std::string sTrue = "true";
 				for (pugi::xml_node gameNode = games.child("rom"); gameNode; gameNode = gameNode.next_sibling("rom"))
 				{
 					if (!gameNode.attribute("id"))
@@ -77,43 +158,30 @@ MameNames::MameNames()
 
 					std::string name = gameNode.attribute("id").value();
 
-					ArcadeRom rom;
-
-					if (gameNode.attribute("device") && gameNode.attribute("device").value() == sTrue)
+					if (gameNode.attribute("device").as_bool())
 					{
-						rom.type |= ArcadeRomType::DEVICE;
-						mArcadeRoms[name] = rom;
+						auto& rom = mArcadeRoms.insert(name);
+						rom.flags = (unsigned int)ArcadeRomType::DEVICE;
+						rom.displayName = 0;
 						continue;
 					}
 
-					if (gameNode.attribute("bios") && gameNode.attribute("bios").value() == sTrue)
+					if (gameNode.attribute("bios").as_bool())
 					{
-						rom.type |= ArcadeRomType::BIOS;
-						mArcadeRoms[name] = rom;
+						auto& rom = mArcadeRoms.insert(name);
+						rom.flags = (unsigned int)ArcadeRomType::BIOS;
+						rom.displayName = 0;
 						continue;
 					}
 
 					if (!gameNode.attribute("name"))
 						continue;
 
-					rom.displayName = gameNode.attribute("name").value();
-
-					if (gameNode.attribute("vert") && gameNode.attribute("vert").value() == sTrue)
-						rom.type |= ArcadeRomType::VERTICAL;
-
-					//if (gameNode.attribute("gun") && gameNode.attribute("gun").value() == sTrue)
-					//	rom.type |= ArcadeRomType::LIGHTGUN;
+					unsigned int displayName = mArcadeRoms.addString(gameNode.attribute("name").value());
 
-					//if (gameNode.attribute("wheel") && gameNode.attribute("wheel").value() == sTrue)
-					//	rom.type |= ArcadeRomType::WHEEL;
-
-					//if (gameNode.attribute("trackball") && gameNode.attribute("trackball").value() == sTrue)
-					//	rom.type |= ArcadeRomType::TRACKBALL;
-
-					//if (gameNode.attribute("spinner") && gameNode.attribute("spinner").value() == sTrue)
-					//	rom.type |= ArcadeRomType::SPINNER;
-
-					mArcadeRoms[name] = rom;
+					auto& rom = mArcadeRoms.insert(name);
+					rom.displayName = displayName;
+					rom.flags = gameNode.attribute("vert").as_bool() ? (unsigned int)ArcadeRomType::VERTICAL : 0;
 				}
 			}
 			else
@@ -123,7 +191,7 @@ MameNames::MameNames()
 			LOG(LogError) << "Error parsing XML file \"" << xmlpath << "\"!\n	" << result.description();
 	}
 	
-	// Read gun games for non arcade systems
+	// Read gun, wheel, trackball & spinner games
 	xmlpath = ResourceManager::getInstance()->getResourcePath(":/gamesdb.xml");
 	if (Utils::FileSystem::exists(xmlpath))
 	{
@@ -140,144 +208,78 @@ MameNames::MameNames()
 					if (!systemNode.attribute("id"))
 						continue;
 
-					std::string systemNames = systemNode.attribute("id").value();
-					for (auto systemName : Utils::String::split(systemNames, ','))
+					struct GameInfo
 					{
-						std::unordered_set<std::string> gunGames;
-						std::unordered_set<std::string> wheelGames;
-						std::unordered_set<std::string> trackballGames;
-						std::unordered_set<std::string> spinnerGames;
-						std::map<std::string, std::string> allGamesNames;
+						std::string id;
+						std::string name;
+						unsigned int flags;
+					};
 
-						for (pugi::xml_node gameNode = systemNode.child("game"); gameNode; gameNode = gameNode.next_sibling("game"))
-						{
-							if (!gameNode.attribute("id"))
-								continue;
+					std::vector<GameInfo> games;
 
-							std::string gameId   = gameNode.attribute("id").value();
-							std::string gameName = gameNode.attribute("name").value();
-							if (gameId.empty() || gameId == "default")
-								continue;
-								
-							if (gameNode.child("gun"))
-								gunGames.insert(gameId);
+					for (pugi::xml_node gameNode = systemNode.child("game"); gameNode; gameNode = gameNode.next_sibling("game"))
+					{
+						if (!gameNode.attribute("id"))
+							continue;
 
-							if (gameNode.child("wheel"))
-								wheelGames.insert(gameId);
+						GameInfo game;
+						game.id = gameNode.attribute("id").value();
+						if (game.id.empty() || game.id == "default")
+							continue;
 
-							if (gameNode.child("trackball"))
-								trackballGames.insert(gameId);
+						game.name = gameNode.attribute("name").value();
+						game.flags = 0;
 
-							if (gameNode.child("spinner"))
-								spinnerGames.insert(gameId);
+						if (gameNode.child("gun"))
+							game.flags |= (unsigned int)ArcadeRomType::LIGHTGUN;
 
-							allGamesNames[gameId] = gameName;
-						}
+						if (gameNode.child("wheel"))
+							game.flags |= (unsigned int)ArcadeRomType::WHEEL;
 
-						if (gunGames.size())
-						{
-							if (systemName == "arcade")
-							{
-								for (auto game : gunGames)
-								{
-									auto it = mArcadeRoms.find(game);
-									if (it == mArcadeRoms.cend())
-									{
-										ArcadeRom rom;
-										rom.type |= ArcadeRomType::LIGHTGUN;
-										rom.displayName = allGamesNames[game];
-										mArcadeRoms[game] = rom;
-									}
-									else 
-										it->second.type |= ArcadeRomType::LIGHTGUN;
-								}
-							}
-							else
-								mNonArcadeGunGames[Utils::String::trim(systemName)] = gunGames;
-						}
+						if (gameNode.child("trackball"))
+							game.flags |= (unsigned int)ArcadeRomType::TRACKBALL;
 
-						if (wheelGames.size())
-						{
-							if (systemName == "arcade")
-							{
-								for (auto game : wheelGames)
-								{
-									auto it = mArcadeRoms.find(game);
-									if (it == mArcadeRoms.cend())
-									{
-										ArcadeRom rom;
-										rom.type |= ArcadeRomType::WHEEL;
-										rom.displayName = allGamesNames[game];
-										mArcadeRoms[game] = rom;
-									}
-									else
-										it->second.type |= ArcadeRomType::WHEEL;
-								}
-							}
-							else
-								mNonArcadeWheelGames[Utils::String::trim(systemName)] = wheelGames;
-						}
+						if (gameNode.child("spinner"))
+							game.flags |= (unsigned int)ArcadeRomType::SPINNER;
 
-						if (trackballGames.size())
-						{
-							if (systemName == "arcade")
-							{
-								for (auto game : trackballGames)
-								{
-									auto it = mArcadeRoms.find(game);
-									if (it == mArcadeRoms.cend())
-									{
-										ArcadeRom rom;
-										rom.type |= ArcadeRomType::TRACKBALL;
-										rom.displayName = allGamesNames[game];
-										mArcadeRoms[game] = rom;
-									}
-									else
-										it->second.type |= ArcadeRomType::TRACKBALL;
-								}
-							}
-							else
-								mNonArcadeTrackballGames[Utils::String::trim(systemName)] = trackballGames;
-						}
+						games.push_back(game);
+					}
 
-						if (spinnerGames.size())
+					std::string systemNames = systemNode.attribute("id").value();
+					for (auto systemName : Utils::String::split(systemNames, ','))
+					{
+						if (systemName == "arcade")
 						{
-							if (systemName == "arcade")
+							// Unknown games are added as simple arcade roms
+							for (auto& game : games)
 							{
-								for (auto game : spinnerGames)
+								auto rom = mArcadeRoms.find(game.id.c_str(), game.id.size());
+								if (rom == nullptr)
 								{
-									auto it = mArcadeRoms.find(game);
-									if (it == mArcadeRoms.cend())
-									{
-										ArcadeRom rom;
-										rom.type |= ArcadeRomType::SPINNER;
-										rom.displayName = allGamesNames[game];
-										mArcadeRoms[game] = rom;
-									}
-									else
-										it->second.type |= ArcadeRomType::SPINNER;
+									unsigned int displayName = game.name.empty() ? 0 : mArcadeRoms.addString(game.name);
+
+									rom = &mArcadeRoms.insert(game.id);
+									rom->displayName = displayName;
 								}
+
+								rom->flags |= game.flags;
 							}
-							else
-								mNonArcadeSpinnerGames[Utils::String::trim(systemName)] = spinnerGames;
+
+							continue;
 						}
 
-						if (allGamesNames.size())
+						InputGames* inputGames = nullptr;
+
+						for (auto& game : games)
 						{
-						  if (systemName == "arcade")
-						    {
-						      for (auto game = allGamesNames.begin(); game != allGamesNames.end(); game++)
-							{
-							  auto it = mArcadeRoms.find(game->second);
-							  if (it == mArcadeRoms.cend())
-							    {
-							      // add as simple arcade rom
-							      ArcadeRom rom;
-							      rom.displayName = allGamesNames[game->second];
-							      mArcadeRoms[game->second] = rom;
-							    }
-							}
-						    }
+							if (game.flags == 0)
+								continue;
+
+							if (inputGames == nullptr)
+								inputGames = &mNonArcadeGames[Utils::String::trim(systemName)];
+
+							inputGames->ids.insert(game.id).flags |= game.flags;
+							inputGames->all.push_back(std::pair<std::string, unsigned int>(game.id, game.flags));
 						}
 					}	
 				}
@@ -288,6 +290,8 @@ MameNames::MameNames()
 		else
 			LOG(LogError) << "Error parsing XML file \"" << xmlpath << "\"!\n	" << result.description();
 	}
+
+	mArcadeRoms.shrink_to_fit();
 	
 } // MameNames
 
@@ -298,9 +302,9 @@ MameNames::~MameNames()
 
 std::string MameNames::getRealName(const std::string& _mameName)
 {
-	auto it = mArcadeRoms.find(_mameName);
-	if (it != mArcadeRoms.cend() && !it->second.displayName.empty())
-		return it->second.displayName;
+	auto rom = mArcadeRoms.find(_mameName.c_str(), _mameName.size());
+	if (rom != nullptr && rom->displayName != 0)
+		return mArcadeRoms.getString(rom->displayName);
 
 	return _mameName;
 
@@ -308,31 +312,34 @@ std::string MameNames::getRealName(const std::string& _mameName)
 
 const bool MameNames::isBiosOrDevice(const std::string& _biosName)
 {
-	auto it = mArcadeRoms.find(_biosName);
-	if (it != mArcadeRoms.cend())
-		return hasFlag(it->second.type, ArcadeRomType::BIOS) || hasFlag(it->second.type, ArcadeRomType::DEVICE);
+	auto rom = mArcadeRoms.find(_biosName.c_str(), _biosName.size());
+	if (rom != nullptr)
+		return (rom->flags & ((unsigned int)ArcadeRomType::BIOS | (unsigned int)ArcadeRomType::DEVICE)) != 0;
 
 	return false;	
 }
 
 const bool MameNames::isVertical(const std::string& _nameName)
 {
-	auto it = mArcadeRoms.find(_nameName);
-	if (it != mArcadeRoms.cend())
-		return hasFlag(it->second.type, ArcadeRomType::VERTICAL);
+	auto rom = mArcadeRoms.find(_nameName.c_str(), _nameName.size());
+	if (rom != nullptr)
+		return (rom->flags & (unsigned int)ArcadeRomType::VERTICAL) != 0;
 
 	return false;
 }
 
-static std::string getIndexedName(const std::string& name)
+static void getIndexedName(const std::string& name, std::string& result)
 {
-	std::string result;
+	result.clear();
 
 	bool inpar = false;
 	bool inblock = false;
 
-	for (auto c : Utils::String::toLower(name))
+	for (auto c : name)
 	{
+		if (c >= 'A' && c <= 'Z')
+			c += 0x20;
+
 		if (!inpar && !inblock && (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9'))
 			result += c;
 		else if (c == '(') inpar = true;
@@ -340,122 +347,73 @@ static std::string getIndexedName(const std::string& name)
 		else if (c == '[') inblock = true;
 		else if (c == ']') inblock = false;
 	}
-
-	return result;
 }
 
-const bool MameNames::isLightgun(const std::string& _nameName, const std::string& systemName, bool isArcade)
+unsigned int MameNames::getInputFlags(const std::string& _nameName, const std::string& systemName, bool isArcade)
 {
 	if (isArcade)
 	{
-		auto it = mArcadeRoms.find(_nameName);
-		if (it != mArcadeRoms.cend())
-			return hasFlag(it->second.type, ArcadeRomType::LIGHTGUN);
+		auto rom = mArcadeRoms.find(_nameName.c_str(), _nameName.size());
+		if (rom != nullptr)
+			return rom->flags & INPUT_FLAGS;
 
 		// if none is found : test on non normed names (aka triforce, teknoparrot)
 	}
 
-	auto it = mNonArcadeGunGames.find(systemName);
-	if (it == mNonArcadeGunGames.cend())
-		return false;
+	auto it = mNonArcadeGames.find(systemName);
+	if (it == mNonArcadeGames.cend())
+		return 0;
 
-	std::string indexedName = getIndexedName(_nameName);
+	// The same game is usually queried for each flag in a row
+	static thread_local std::string lastName;
+	static thread_local std::string lastSystem;
+	static thread_local unsigned int lastFlags = 0;
 
-	// Exact match ?
-	if (it->second.find(indexedName) != it->second.cend())
-		return true;
-
-	// name contains ?
-	for (auto gameId : it->second)
-		if (indexedName.find(gameId) != std::string::npos)
-			return true;
-
-	return false;
-}
-
-const bool MameNames::isWheel(const std::string& _nameName, const std::string& systemName, bool isArcade)
-{
-	if (isArcade)
-	{
-		auto it = mArcadeRoms.find(_nameName);
-		if (it != mArcadeRoms.cend())
-			return hasFlag(it->second.type, ArcadeRomType::WHEEL);
-
-		// if none is found : test on non normed names (aka triforce, teknoparrot)
-	}
+	if (lastName == _nameName && lastSystem == systemName)
+		return lastFlags;
 
-	auto it = mNonArcadeWheelGames.find(systemName);
-	if (it == mNonArcadeWheelGames.cend())
-		return false;
+	static thread_local std::string indexedName;
+	getIndexedName(_nameName, indexedName);
 
-	std::string indexedName = getIndexedName(_nameName);
+	unsigned int flags = 0;
 
 	// Exact match ?
-	if (it->second.find(indexedName) != it->second.cend())
-		return true;
+	auto game = it->second.ids.find(indexedName.c_str(), indexedName.size());
+	if (game != nullptr)
+		flags = game->flags;
 
 	// name contains ?
-	for (auto gameId : it->second)
-		if (indexedName.find(gameId) != std::string::npos)
-			return true;
-
-	return false;
-}
-
-const bool MameNames::isTrackball(const std::string& _nameName, const std::string& systemName, bool isArcade)
-{
-	if (isArcade)
+	for (auto& gameId : it->second.all)
 	{
-		auto it = mArcadeRoms.find(_nameName);
-		if (it != mArcadeRoms.cend())
-			return hasFlag(it->second.type, ArcadeRomType::TRACKBALL);
+		if ((flags & gameId.second) == gameId.second)
+			continue;
 
-		// if none is found : test on non normed names (aka triforce, teknoparrot)
+		if (indexedName.find(gameId.first) != std::string::npos)
+			flags |= gameId.second;
 	}
 
-	auto it = mNonArcadeTrackballGames.find(systemName);
-	if (it == mNonArcadeTrackballGames.cend())
-		return false;
-
-	std::string indexedName = getIndexedName(_nameName);
+	lastName = _nameName;
+	lastSystem = systemName;
+	lastFlags = flags;
+	return flags;
+}
 
-	// Exact match ?
-	if (it->second.find(indexedName) != it->second.cend())
-		return true;
+const bool MameNames::isLightgun(const std::string& _nameName, const std::string& systemName, bool isArcade)
+{
+	return (getInputFlags(_nameName, systemName, isArcade) & (unsigned int)ArcadeRomType::LIGHTGUN) != 0;
+}
 
-	// name contains ?
-	for (auto gameId : it->second)
-		if (indexedName.find(gameId) != std::string::npos)
-			return true;
+const bool MameNames::isWheel(const std::string& _nameName, const std::string& systemName, bool isArcade)
+{
+	return (getInputFlags(_nameName, systemName, isArcade) & (unsigned int)ArcadeRomType::WHEEL) != 0;
+}
 
-	return false;
+const bool MameNames::isTrackball(const std::string& _nameName, const std::string& systemName, bool isArcade)
+{
+	return (getInputFlags(_nameName, systemName, isArcade) & (unsigned int)ArcadeRomType::TRACKBALL) != 0;
 }
 
 const bool MameNames::isSpinner(const std::string& _nameName, const std::string& systemName, bool isArcade)
 {
-	if (isArcade)
-	{
-		auto it = mArcadeRoms.find(_nameName);
-		if (it != mArcadeRoms.cend())
-			return hasFlag(it->second.type, ArcadeRomType::SPINNER);
-
-		// if none is found : test on non normed names (aka triforce, teknoparrot)
-	}
-
-	auto it = mNonArcadeSpinnerGames.find(systemName);
-	if (it == mNonArcadeSpinnerGames.cend())
-		return false;
-
-	std::string indexedName = getIndexedName(_nameName);
-
-	// Exact match ?
-	if (it->second.find(indexedName) != it->second.cend())
-		return true;
-
-	// name contains ?
-	for (auto gameId : it->second)
-		if (indexedName.find(gameId) != std::string::npos)
-			return true;
-
-	return false;
+	return (getInputFlags(_nameName, systemName, isArcade) & (unsigned int)ArcadeRomType::SPINNER) != 0;
 }
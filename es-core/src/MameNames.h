@@ -4,9 +4,7 @@
 
 #include <string>
 #include <vector>
-#include <unordered_set>
 #include <unordered_map>
-#include <map>
 
 class SystemData;
 
@@ -22,14 +20,6 @@ enum class ArcadeRomType
 	SPINNER = 64,
 };
 
-struct ArcadeRom
-{	
-	ArcadeRom() { type = ArcadeRomType::NONE; }
-
-	std::string displayName;
-	ArcadeRomType type;
-};
-
 class MameNames
 {
 public:
@@ -40,9 +30,12 @@ public:
 	const bool        isBiosOrDevice(const std::string& _biosName);	
 	const bool        isVertical(const std::string& _nameName);
 	const bool		  isLightgun(const std::string& _nameName, const std::string& systemName, bool isArcade);
-  	const bool		  isWheel(const std::string& _nameName, const std::string& systemName, bool isArcade);
-    	const bool		  isTrackball(const std::string& _nameName, const std::string& systemName, bool isArcade);
-      	const bool		  isSpinner(const std::string& _nameName, const std::string& systemName, bool isArcade);
+	const bool		  isWheel(const std::string& _nameName, const std::string& systemName, bool isArcade);
+	const bool		  isTrackball(const std::string& _nameName, const std::string& systemName, bool isArcade);
+	const bool		  isSpinner(const std::string& _nameName, const std::string& systemName, bool isArcade);
+
+	// LIGHTGUN, WHEEL, TRACKBALL & SPINNER flags of a game, found with a single lookup
+	unsigned int	  getInputFlags(const std::string& _nameName, const std::string& systemName, bool isArcade);
 
 private:
 	 MameNames();
@@ -50,12 +43,46 @@ private:
 
 	static MameNames* sInstance;
 
-	std::unordered_map<std::string, ArcadeRom> mArcadeRoms;
+	// Open addressing hash table : the names are kept in a single string pool, so a lookup does not allocate
+	class NameTable
+	{
+	public:
+		struct Entry
+		{
+			unsigned int hash;
+			unsigned int name;			// offset in the pool + 1, 0 if the entry is free
+			unsigned int displayName;	// offset in the pool + 1, 0 if none
+			unsigned int flags;			// ArcadeRomType
+		};
+
+		NameTable();
+
+		Entry* find(const char* name, size_t length);
+		Entry& insert(const std::string& name);
+
+		const char*  getString(unsigned int offset) const { return mStrings.c_str() + offset - 1; }
+		unsigned int addString(const std::string& value);
+
+		void shrink_to_fit() { mStrings.shrink_to_fit(); }
+
+	private:
+		void grow();
+
+		std::vector<Entry> mEntries;
+		std::string		   mStrings;
+		size_t			   mCount;
+	};
+
+	NameTable mArcadeRoms;
+
+	// Games of the other systems, by indexed name
+	struct InputGames
+	{
+		NameTable ids;
+		std::vector<std::pair<std::string, unsigned int>> all;
+	};
 
-	std::unordered_map<std::string, std::unordered_set<std::string>> mNonArcadeGunGames;
-  	std::unordered_map<std::string, std::unordered_set<std::string>> mNonArcadeWheelGames;
-    	std::unordered_map<std::string, std::unordered_set<std::string>> mNonArcadeTrackballGames;
-      	std::unordered_map<std::string, std::unordered_set<std::string>> mNonArcadeSpinnerGames;
+	std::unordered_map<std::string, InputGames> mNonArcadeGames;
 
 }; // MameNames
 
@@ -190,6 +190,7 @@ void Settings::setDefaults()
 	mBoolMap["ScrapeDescription"] = true;
 	mBoolMap["ScrapePadToKey"] = true;
 	mBoolMap["ScrapeOverWrite"] = true;	
+	mBoolMap["ScrapeCache"] = true;
 	mBoolMap["IgnoreGamelist"] = false;
 	mBoolMap["HideConsole"] = true;
 	mBoolMap["QuickSystemSelect"] = true;
@@ -218,6 +219,7 @@ void Settings::setDefaults()
 	mIntMap["FpsLimit"] = 0;
 	mIntMap["ScraperResizeWidth"] = 640;
 	mIntMap["ScraperResizeHeight"] = 0;
+	mIntMap["ScrapeCacheDays"] = 7;
 
 #if defined(_WIN32) || defined(TINKERBOARD) || defined(X86) || defined(X86_64) || defined(ODROIDN2) || defined(ODROIDC2) || defined(ODROIDXU4) || defined(RPI4)
 	// Boards > 1Gb RAM
@@ -342,6 +344,12 @@ void Settings::setDefaults()
 	mBoolMap["PreloadMedias"] = Settings::_PreloadMedias;
 	mBoolMap["OptimizeVRAM"] = true;
 	mBoolMap["OptimizeVideo"] = true;
+	mBoolMap["TextureAtlas"] = false;
+	mBoolMap["SkipUnchangedFrames"] = false;
+	mBoolMap["FontDistanceField"] = false;
+	mBoolMap["VideoYUV"] = true;
+	mBoolMap["VideoProxies"] = false;
+	mBoolMap["VideoPreroll"] = false;
 
 	mBoolMap["ShowFilenames"] = false;
 
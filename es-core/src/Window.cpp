@@ -3,8 +3,10 @@
 #include "components/HelpComponent.h"
 #include "components/ImageComponent.h"
 #include "components/TextComponent.h"
+#include "components/VideoComponent.h"
 #include "resources/Font.h"
 #include "resources/TextureResource.h"
+#include "resources/VideoProxyCache.h"
 #include "InputManager.h"
 #include "Log.h"
 #include "Scripting.h"
@@ -33,7 +35,7 @@
 #include <SDL_syswm.h>
 #endif
 
-Window::Window() : mNormalizeNextUpdate(false), mFrameTimeElapsed(0), mFrameCountElapsed(0), mAverageDeltaTime(10),
+Window::Window() : mNormalizeNextUpdate(false), mFrameTimeElapsed(0), mFrameCountElapsed(0), mAverageDeltaTime(10), mSkippedFrames(0), mFrameSkipped(false), mTimeSinceLastDamage(0),
   mAllowSleep(true), mSleeping(false), mTimeSinceLastInput(0), mScreenSaver(NULL), mRenderScreenSaver(false), mClockElapsed(0), mMouseCapture(nullptr), mMenuBackgroundShaderTextureCache(-1)
 {			
 	mTransitionOffset = 0;
@@ -65,6 +67,7 @@ Window::~Window()
 void Window::pushGui(GuiComponent* gui)
 {
 	resetMenuBackgroundShader();
+	GuiComponent::invalidateFrame();
 
 	if (mGuiStack.size() > 0)
 	{
@@ -82,6 +85,7 @@ void Window::pushGui(GuiComponent* gui)
 void Window::removeGui(GuiComponent* gui)
 {
 	resetMenuBackgroundShader();
+	GuiComponent::invalidateFrame();
 
 	if (mMouseCapture == gui)
 		mMouseCapture = nullptr;
@@ -201,6 +205,8 @@ void Window::deinit(bool deinitRenderer)
 
 	TextureResource::clearQueue();
 	ResourceManager::getInstance()->unloadAll();
+	GlyphCache::saveAll();
+	VideoProxyCache::stop();
 
 	if (deinitRenderer)
 		Renderer::deinit();
@@ -208,6 +214,8 @@ void Window::deinit(bool deinitRenderer)
 
 void Window::textInput(const char* text)
 {
+	GuiComponent::invalidateFrame();
+
 	if(peekGui())
 		peekGui()->textInput(text);
 }
@@ -216,6 +224,8 @@ void Window::input(InputConfig* config, Input input)
 {
 	if (config == nullptr)
 		return;
+
+	GuiComponent::invalidateFrame();
 	
 	if (config->getDeviceIndex() >= 0 && Settings::getInstance()->getBool("FirstJoystickOnly"))
 	{
@@ -295,6 +305,7 @@ static std::mutex mNotificationMessagesLock;
 void Window::displayNotificationMessage(std::string message, int duration)
 {
 	std::unique_lock<std::mutex> lock(mNotificationMessagesLock);
+	GuiComponent::invalidateFrame();
 
 	if (duration <= 0)
 	{
@@ -485,12 +496,19 @@ void Window::update(int deltaTime)
 			int queueSize = TextureResource::getQueueSize();
 
 			ss << "\nFont VRAM: " << fontVramUsageMb << " Tex VRAM: " << textureVramUsageMb << " Cached Tex RAM: " << textureCacheUsageMb << " Known Tex: " << textureKnownUsageMb << " Max VRAM: " << max_texture << " Queued : " << queueSize;
+
+			if (Settings::getInstance()->getBool("SkipUnchangedFrames"))
+				ss << " Skipped frames: " << mSkippedFrames;
+
+			if (VideoComponent::getTimeToFirstFrame() >= 0)
+				ss << "\nVideo first frame: " << VideoComponent::getTimeToFirstFrame() << "ms";
 			
 			mFrameDataText = std::unique_ptr<TextCache>(mDefaultFonts[3]->buildTextCache(ss.str(), Vector2f(50.f, 50.f), 0xFFFF40FF, 0.0f, ALIGN_LEFT, 1.2f));
 		}
 
 		mFrameTimeElapsed = 0;
 		mFrameCountElapsed = 0;
+		mSkippedFrames = 0;
 	}
 
 	/* draw the clock */ 
@@ -521,6 +539,7 @@ void Window::update(int deltaTime)
 	}
 
 	mTimeSinceLastInput += deltaTime;
+	mTimeSinceLastDamage += deltaTime;
 
 	if (peekGui())
 		peekGui()->update(deltaTime);
@@ -669,8 +688,38 @@ void Window::resetMenuBackgroundShader()
 	}
 }
 
+bool Window::canSkipFrame()
+{
+	if (GuiComponent::consumeFrameDamage())
+		mTimeSinceLastDamage = 0;
+
+	if (!Settings::getInstance()->getBool("SkipUnchangedFrames"))
+		return false;
+
+	// Keep rendering a bit after the last change, so lerped animations (camera, fades) can settle
+	if (mTimeSinceLastDamage < 1000)
+		return false;
+
+	if (mRenderScreenSaver || mCalibrationText != nullptr || mNotificationPopups.size() || mAsyncNotificationComponent.size())
+		return false;
+
+	if (Settings::DrawGunCrosshair() && InputManager::getInstance()->getGuns().size())
+		return false;
+
+	return true;
+}
+
 void Window::render()
 {
+	mFrameSkipped = canSkipFrame();
+	if (mFrameSkipped)
+	{
+		// Nothing changed since the last presented frame : keep it on screen
+		mSkippedFrames++;
+		processScreenSaverTimeout();
+		return;
+	}
+
 	Transform4x4f transform = Transform4x4f::Identity();
 
 	mRenderedHelpPrompts = false;
@@ -757,9 +806,7 @@ void Window::render()
 
 	Renderer::setMatrix(transform);
 
-	unsigned int screensaverTime = (unsigned int)Settings::ScreenSaverTime();
-	if (mTimeSinceLastInput >= screensaverTime && screensaverTime != 0)
-		startScreenSaver();
+	processScreenSaverTimeout();
 
 	// Render notifications
 	if (!mRenderScreenSaver)
@@ -783,18 +830,6 @@ void Window::render()
 	if (mVolumeInfo && Settings::VolumePopup())
 		mVolumeInfo->render(transform);
 
-	if (mTimeSinceLastInput >= screensaverTime && screensaverTime != 0)
-	{
-		if (mAllowSleep && (!mScreenSaver || mScreenSaver->allowSleep()))
-		{
-			// go to sleep
-			if (mSleeping == false) {
-				mSleeping = true;
-				onSleep();
-			}
-		}
-	}
-
 	// Render calibration dark background & text
 	if (mCalibrationText)
 	{
@@ -1058,9 +1093,26 @@ void Window::setHelpPrompts(const std::vector<HelpPrompt>& prompts, const HelpSt
 	});
 
 	mHelp->setPrompts(addPrompts);
+	GuiComponent::invalidateFrame();
 }
 
 
+void Window::processScreenSaverTimeout()
+{
+	unsigned int screensaverTime = (unsigned int)Settings::ScreenSaverTime();
+	if (mTimeSinceLastInput < screensaverTime || screensaverTime == 0)
+		return;
+
+	startScreenSaver();
+
+	// go to sleep
+	if (!mSleeping && mAllowSleep && (!mScreenSaver || mScreenSaver->allowSleep()))
+	{
+		mSleeping = true;
+		onSleep();
+	}
+}
+
 void Window::onSleep()
 {
 	Scripting::fireEvent("sleep");
@@ -1259,12 +1311,17 @@ void Window::processPostedFunctions()
 
 	mNotificationMessagesLock.unlock();
 
+	if (functions.size())
+		GuiComponent::invalidateFrame();
+
 	for (auto func : functions)
 		TRYCATCH("processPostedFunction", func.func())
 }
 
 void Window::onThemeChanged(const std::shared_ptr<ThemeData>& theme)
 {
+	GuiComponent::invalidateFrame();
+
 	for (auto extra : mScreenExtras)
 		delete extra;
 
@@ -1399,6 +1456,8 @@ void Window::processMouseMove(int x, int y, bool touchScreen)
 
 	mLastMousePoint.x() = point.x(); mLastMousePoint.y() = point.y();
 
+	GuiComponent::invalidateFrame();
+
 	GuiComponent* gui = peekGui();
 	if (!gui)
 		return;
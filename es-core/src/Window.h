@@ -67,6 +67,7 @@ public:
 	void normalizeNextUpdate();
 
 	inline bool isSleeping() const { return mSleeping; }
+	inline bool isFrameSkipped() const { return mFrameSkipped; }
 	bool getAllowSleep();
 	void setAllowSleep(bool sleep);
 	
@@ -117,6 +118,8 @@ private:
 
 	void processPostedFunctions();
 	void renderSindenBorders();
+	bool canSkipFrame();
+	void processScreenSaverTimeout(); // Starts the screensaver & goes to sleep when no input came for ScreenSaverTime
 
 	std::vector<AsyncNotificationComponent*> mAsyncNotificationComponent;
 	void updateAsyncNotifications(int deltaTime);
@@ -157,6 +160,10 @@ private:
 	int mFrameTimeElapsed;
 	int mFrameCountElapsed;
 	int mAverageDeltaTime;
+	int mSkippedFrames;
+
+	bool mFrameSkipped;
+	int mTimeSinceLastDamage;
 
 	std::unique_ptr<TextCache> mFrameDataText;
 
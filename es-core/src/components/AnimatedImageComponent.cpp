@@ -55,6 +55,7 @@ void AnimatedImageComponent::update(int deltaTime)
 	if(!mEnabled || mFrames.size() == 0)
 		return;
 
+	GuiComponent::invalidateFrame();
 	mFrameAccumulator += deltaTime;
 
 	while(mFrames.at(mCurrentFrame).second <= mFrameAccumulator)
@@ -52,7 +52,8 @@ void BusyComponent::setBackgroundVisible(bool visible)
 
 void BusyComponent::update(int deltaTime)
 {
-	GuiComponent::update(deltaTime);	
+	GuiComponent::update(deltaTime);
+	GuiComponent::invalidateFrame();
 	// mAnimation->setRotation(mAnimation->getRotation() - (deltaTime / 333.3));
 }
 
@@ -164,7 +164,7 @@ std::shared_ptr<TextureResource> HelpComponent::getIconTexture(const std::string
 	auto itMap = mStyle.iconMap.find(name);
 	if (itMap != mStyle.iconMap.end() && ResourceManager::getInstance()->fileExists(itMap->second))
 	{
-		auto tmp = TextureResource::get(itMap->second, false, false, true);
+		auto tmp = TextureResource::get(itMap->second, false, false, true, true, true, nullptr, "", true);
 		mIconCache[name] = tmp;
 		return tmp;
 	}
@@ -182,7 +182,7 @@ std::shared_ptr<TextureResource> HelpComponent::getIconTexture(const std::string
 		return nullptr;
 	}
 
-	std::shared_ptr<TextureResource> tex = TextureResource::get(pathLookup->second, false, false, true);
+	std::shared_ptr<TextureResource> tex = TextureResource::get(pathLookup->second, false, false, true, true, true, nullptr, "", true);
 	mIconCache[name] = tex;
 	return tex;
 }
@@ -233,6 +233,8 @@ public:
 
 	inline int size() const { return (int)mEntries.size(); }
 
+	inline const UserData& getObjectAt(int index) const { return mEntries.at(index).object; }
+
 	inline std::vector<UserData> getObjects()
 	{
 		std::vector<UserData> objects;
@@ -301,9 +303,14 @@ protected:
 		else
 			mTitleOverlayOpacity = (unsigned char)op;
 
+		if(mTitleOverlayOpacity != 0 && mTitleOverlayOpacity != 255)
+			GuiComponent::invalidateFrame();
+
 		if(mScrollVelocity == 0 || size() < 2)
 			return;
 
+		GuiComponent::invalidateFrame();
+
 		mScrollCursorAccumulator += deltaTime;
 		mScrollTierAccumulator += deltaTime;
 
@@ -37,7 +37,7 @@ ImageComponent::ImageComponent(Window* window, bool forceLoad, bool dynamic) : G
 	mTargetIsMax(false), mTargetIsMin(false), mFlipX(false), mFlipY(false), mTargetSize(0, 0), mColorShift(0xFFFFFFFF),
 	mColorShiftEnd(0xFFFFFFFF), mColorGradientHorizontal(true), mForceLoad(forceLoad), mDynamic(dynamic),
 	mFadeOpacity(0), mFading(false), mRotateByTargetSize(false), mTopLeftCrop(0.0f, 0.0f), mBottomRightCrop(1.0f, 1.0f),
-	mReflection(0.0f, 0.0f), mSharedTexture(true), mCustomShaderEnabled(true)
+	mReflection(0.0f, 0.0f), mSharedTexture(true), mCustomShaderEnabled(true), mTextureRect(0.0f, 0.0f, 1.0f, 1.0f)
 {
 	mTextureLoaded = false;
 	mLoadingTextureLoaded = false;
@@ -273,6 +273,17 @@ void ImageComponent::updateVertices()
 			mVertices[i].tex[1] = py - mVertices[i].tex[1];
 	}
 
+	// Small images may be packed into a shared atlas page : remap to their area
+	mTextureRect = mTexture->getTextureRect();
+	if (mTextureRect != Vector4f(0.0f, 0.0f, 1.0f, 1.0f))
+	{
+		for (int i = 0; i < 4; ++i)
+		{
+			mVertices[i].tex[0] = mTextureRect.x() + mVertices[i].tex[0] * mTextureRect.z();
+			mVertices[i].tex[1] = mTextureRect.y() + mVertices[i].tex[1] * mTextureRect.w();
+		}
+	}
+
 	updateColors();
 	updateRoundCorners();
 }
@@ -357,12 +368,15 @@ void ImageComponent::setImage(const std::string&  path, bool tile, const MaxSize
 		}
 	}
 
+	// Custom shaders expect the texture coordinates & the size of the image itself, not of an atlas page
+	bool allowAtlas = mCustomShader.path.empty();
+
 	if (mPath.empty() || (checkFileExists && !ResourceManager::getInstance()->fileExists(mPath)))
 	{
 		if (mDefaultPath.empty() || !ResourceManager::getInstance()->fileExists(mDefaultPath))
 			mTexture.reset();
 		else
-			mTexture = TextureResource::get(mDefaultPath, tile, mLinear, mForceLoad, mDynamic, true, maxSize.empty() ? pDefaultMaxSize : &maxSize, shareId);
+			mTexture = TextureResource::get(mDefaultPath, tile, mLinear, mForceLoad, mDynamic, true, maxSize.empty() ? pDefaultMaxSize : &maxSize, shareId, allowAtlas);
 	} 
 	else
 	{
@@ -370,7 +384,7 @@ void ImageComponent::setImage(const std::string&  path, bool tile, const MaxSize
 			mTexture = mPlaylistCache[mPath];
 		else
 		{
-			std::shared_ptr<TextureResource> texture = TextureResource::get(mPath, tile, mLinear, mForceLoad, mDynamic, true, maxSize.empty() ? pDefaultMaxSize : &maxSize, shareId);
+			std::shared_ptr<TextureResource> texture = TextureResource::get(mPath, tile, mLinear, mForceLoad, mDynamic, true, maxSize.empty() ? pDefaultMaxSize : &maxSize, shareId, allowAtlas);
 
 			if (mPlaylist != nullptr)
 				mPlaylistCache[mPath] = texture;
@@ -396,6 +410,8 @@ void ImageComponent::setImage(const std::string&  path, bool tile, const MaxSize
 
 	if (mLoadingTexture == nullptr && !mTargetSize.empty())
 		resize();
+
+	GuiComponent::invalidateFrame();
 }
 
 void ImageComponent::setImage(const char* path, size_t length, bool tile)
@@ -415,6 +431,7 @@ void ImageComponent::setImage(const char* path, size_t length, bool tile)
 	mTextureLoaded = mTexture != nullptr && mTexture->isLoaded();
 
 	resize();
+	GuiComponent::invalidateFrame();
 }
 
 void ImageComponent::setImage(const std::shared_ptr<TextureResource>& texture)
@@ -429,6 +446,7 @@ void ImageComponent::setImage(const std::shared_ptr<TextureResource>& texture)
 		mTexture->setRequired(true);
 
 	resize();
+	GuiComponent::invalidateFrame();
 }
 
 void ImageComponent::setResize(float width, float height)
@@ -675,6 +693,10 @@ void ImageComponent::render(const Transform4x4f& parentTrans)
 			return;
 		}
 
+		// The atlas area is only known once the texture is uploaded
+		if (mTexture->getTextureRect() != mTextureRect)
+			updateVertices();
+
 		beginCustomClipRect();
 
 		// Align left
@@ -1070,7 +1092,10 @@ void ImageComponent::update(int deltaTime)
 {
 	GuiComponent::update(deltaTime);
 
-	watchTextureLoading(); // Required when preloading
+	if (watchTextureLoading() || mFading) // Required when preloading
+		GuiComponent::invalidateFrame();
+	else if (mCustomShaderEnabled && !mCustomShader.path.empty() && isShowing() && isVisible() && Renderer::shaderIsAnimated(mCustomShader.path))
+		GuiComponent::invalidateFrame(); // The shader draws something different on each frame
 
 	if (mPlaylist && isShowing())
 	{
@@ -1237,6 +1262,14 @@ void ImageComponent::setCustomShader(const Renderer::ShaderInfo& customShader)
 		}
 	}
 
+	// The current image may have been packed in the atlas : load it again as a standalone texture
+	if (sav.path.empty() && !mCustomShader.path.empty() && !mPath.empty() && mTexture != nullptr)
+	{
+		std::string path = mPath;
+		mPath = "";
+		setImage(path, mTexture->isTiled());
+	}
+
 	updateRoundCorners();
 }
 
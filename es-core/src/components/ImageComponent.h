@@ -148,6 +148,7 @@ private:
 	// Used internally whenever the resizing parameters or texture change.
 
 	Renderer::Vertex mVertices[4];
+	Vector4f mTextureRect; // Texture area the vertices were computed for ( changes when packed into the atlas )
 
 	void updateVertices();
 	void updateColors();
@@ -63,6 +63,7 @@ void ScrollableContainer::update(int deltaTime)
 {
 	if(mAutoScrollSpeed != 0)
 	{
+		GuiComponent::invalidateFrame();
 		mAutoScrollAccumulator += deltaTime;
 
 		//scale speed by our width! more text per line = slower scrolling
@@ -317,6 +317,8 @@ void TextComponent::onTextChanged()
 	mTextLength = -1;
 	mTextCache = nullptr;
 
+	GuiComponent::invalidateFrame();
+
 	if (mAutoCalcExtent.x())
 	{
 		auto text = mUppercase ? Utils::String::toUpper(mText) : mText;
@@ -425,6 +427,9 @@ void TextComponent::update(int deltaTime)
 		return;
 	}
 
+	int marqueeOffset = mMarqueeOffset;
+	int marqueeOffset2 = mMarqueeOffset2;
+
 	int sy = mSize.y() - mPadding.y() - mPadding.w();
 
 	bool isMultiline = mMultiline == MultiLineType::MULTILINE;
@@ -516,6 +521,9 @@ void TextComponent::update(int deltaTime)
 		mMarqueeOffset = 0;
 		mMarqueeOffset2 = 0;
 	}
+
+	if (marqueeOffset != mMarqueeOffset || marqueeOffset2 != mMarqueeOffset2)
+		GuiComponent::invalidateFrame();
 }
 
 void TextComponent::onShow()
@@ -543,6 +543,8 @@ void TextListComponent<T>::update(int deltaTime)
 
 		if (textLength > limit)
 		{
+			GuiComponent::invalidateFrame();
+
 			// loop
 			// pixels per second ( based on nes-mini font at 1920x1080 to produce a speed of 200 )
 			const float speed = mFont->sizeText("ABCDEFGHIJKLMNOPQRSTUVWXYZ").x() * 0.247f;
@@ -49,6 +49,8 @@ void writeSubtitle(const char* gameName, const char* systemName, bool always)
 	}
 }
 
+int VideoComponent::sTimeToFirstFrame = -1;
+
 void VideoComponent::setScreensaverMode(bool isScreensaver)
 {
 	mScreensaverMode = isScreensaver;
@@ -431,6 +433,9 @@ void VideoComponent::update(int deltaTime)
 
 	if (mIsPlaying)
 	{
+		// Each decoded frame changes the screen
+		GuiComponent::invalidateFrame();
+
 		// If the video start is delayed and there is less than the fade time then set the image fade
 		// accordingly
 
@@ -163,6 +163,12 @@ public:
 
 	bool showSnapshots();
 
+	// Prepares the videos likely to be played next (ex: neighbours of the selected game), so they start instantly
+	virtual void prerollVideos(const std::vector<std::string>& paths) { }
+
+	// Delay between the last video start & its first frame on screen, in ms. -1 if no video was played
+	static int getTimeToFirstFrame() { return sTimeToFirstFrame; }
+
 protected:
 	std::shared_ptr<IPlaylist> mPlaylist;
 	std::function<bool()> mVideoEnded;
@@ -223,6 +229,8 @@ protected:
 	float							mRoundCorners;
 
 	Configuration					mConfig;
+
+	static int						sTimeToFirstFrame;
 };
 
 #endif // ES_CORE_COMPONENTS_VIDEO_COMPONENT_H
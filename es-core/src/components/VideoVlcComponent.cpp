@@ -2,6 +2,7 @@
 
 #include "renderers/Renderer.h"
 #include "resources/TextureResource.h"
+#include "resources/VideoProxyCache.h"
 #include "utils/StringUtil.h"
 #include "PowerSaver.h"
 #include "Settings.h"
@@ -9,6 +10,7 @@
 #include <vlc/libvlc_version.h>
 #include <SDL_mutex.h>
 #include <cmath>
+#include <algorithm>
 #include "SystemConf.h"
 #include "ThemeData.h"
 #include <SDL_timer.h>
@@ -22,18 +24,29 @@
 
 #define MATHPI          3.141592653589793238462643383279502884L
 
+#define VLC_PLAYER_POOL_SIZE	3
+#define VIDEO_PREROLL_COUNT		2
+
 libvlc_instance_t* VideoVlcComponent::mVLC = NULL;
 
+// Stopped media players, ready to be reused : creating a player spawns VLC threads & allocates its buffers
+static std::mutex sPlayerPoolLock;
+static std::vector<libvlc_media_player_t*> sPlayerPool;
+
 // VLC prepares to render a video frame.
 static void *lock(void *data, void **p_pixels) 
 {
 	struct VideoContext *c = (struct VideoContext *)data;
 
-	int frame = (c->surfaceId ^ 1);
-	
-	c->mutexes[frame].lock();
-	c->hasFrame[frame] = false;
-	*p_pixels = c->surfaces[frame];
+	unsigned char* surface = c->getWriteSurface();
+	*p_pixels = surface;
+
+	if (c->planar)
+	{
+		p_pixels[1] = surface + c->width * c->height;
+		p_pixels[2] = (unsigned char*)p_pixels[1] + (c->width / 2) * (c->height / 2);
+	}
+
 	return NULL; // Picture identifier, not needed here.
 }
 
@@ -41,12 +54,7 @@ static void *lock(void *data, void **p_pixels)
 static void unlock(void *data, void* /*id*/, void *const* /*p_pixels*/) 
 {
 	struct VideoContext *c = (struct VideoContext *)data;
-
-	int frame = (c->surfaceId ^ 1);	
-
-	c->surfaceId = frame;
-	c->hasFrame[frame] = true;
-	c->mutexes[frame].unlock();
+	c->publishFrame();
 }
 
 // VLC wants to display a video frame.
@@ -60,6 +68,73 @@ static void display(void* data, void* id)
 		c->component->onVideoStarted();
 }
 
+// VLC asks for the frame format : RGBA or I420 planes, tightly packed in the context surfaces
+static unsigned formatSetup(void** opaque, char* chroma, unsigned* width, unsigned* height, unsigned* pitches, unsigned* lines)
+{
+	struct VideoContext *c = (struct VideoContext *)*opaque;
+
+	*width = c->width;
+	*height = c->height;
+
+	if (!c->planar)
+	{
+		memcpy(chroma, "RGBA", 4);
+		pitches[0] = c->width * 4;
+		lines[0] = c->height;
+		return 1;
+	}
+
+	memcpy(chroma, "I420", 4);
+	pitches[0] = c->width;
+	lines[0] = c->height;
+	pitches[1] = pitches[2] = c->width / 2;
+	lines[1] = lines[2] = c->height / 2;
+
+	return 1;
+}
+
+static libvlc_media_player_t* acquireMediaPlayer(libvlc_media_t* media)
+{
+	{
+		std::unique_lock<std::mutex> lock(sPlayerPoolLock);
+		if (!sPlayerPool.empty())
+		{
+			libvlc_media_player_t* player = sPlayerPool.back();
+			sPlayerPool.pop_back();
+
+			libvlc_media_player_set_media(player, media);
+			return player;
+		}
+	}
+
+	return libvlc_media_player_new_from_media(media);
+}
+
+static void recycleMediaPlayer(libvlc_media_player_t* player)
+{
+	// The player must be stopped
+	libvlc_media_player_set_media(player, nullptr);
+
+	std::unique_lock<std::mutex> lock(sPlayerPoolLock);
+	if (sPlayerPool.size() < VLC_PLAYER_POOL_SIZE)
+		sPlayerPool.push_back(player);
+	else
+		libvlc_media_player_release(player);
+}
+
+static void setupMediaPlayer(libvlc_media_player_t* player, VideoContext* context)
+{
+	// Always set both : a pooled player keeps the callbacks of its previous video
+	libvlc_video_set_callbacks(player, lock, unlock, display, (void*)context);
+	libvlc_video_set_format_callbacks(player, formatSetup, nullptr);
+}
+
+static bool isPlanarVideo(unsigned width)
+{
+	// I420 frames need no colour conversion in VLC and are 2.7 times smaller than RGBA ones
+	return width > 1 && Settings::getInstance()->getBool("VideoYUV") && Renderer::supportYUVTextures();
+}
+
 VideoVlcComponent::VideoVlcComponent(Window* window) : VideoComponent(window), 
 	mMediaPlayer(nullptr), mMedia(nullptr),
 	mTopLeftCrop(0.0f, 0.0f), mBottomRightCrop(1.0f, 1.0f), mContext(nullptr)
@@ -73,6 +148,9 @@ VideoVlcComponent::VideoVlcComponent(Window* window) : VideoComponent(window),
 	mLoops = -1;
 	mCurrentLoop = 0;
 
+	mPlaneTextures[0] = mPlaneTextures[1] = mPlaneTextures[2] = 0;
+	mStartVideoTime = 0;
+
 	// Get an empty texture for rendering the video
 	mTexture = nullptr;// TextureResource::get("");
 	mEffect = VideoVlcFlags::VideoVlcEffect::BUMP;
@@ -89,14 +167,17 @@ static void mediaplayer_release_async(VideoContext* ctx, libvlc_media_player_t*
 	ctx->component = nullptr;
 
 	std::thread([p_mi, ctx]()
-		{			
-			libvlc_media_player_release(p_mi);
+		{
+			// Stopping joins the VLC threads : the context can only be deleted after it
+			libvlc_media_player_stop(p_mi);
 			if (ctx) delete ctx;
+			recycleMediaPlayer(p_mi);
 		}).detach();
 }
 
 VideoVlcComponent::~VideoVlcComponent()
 {
+	releasePrerolledVideos();
 	stopVideo();
 }
 
@@ -436,6 +517,7 @@ void VideoVlcComponent::render(const Transform4x4f& parentTrans)
 	VideoComponent::render(parentTrans);
 
 	bool initFromPixels = true;
+	bool renderPlanes = false;
 
 	if (!mIsPlaying || !mContext || mIsParsing)
 	{
@@ -471,8 +553,7 @@ void VideoVlcComponent::render(const Transform4x4f& parentTrans)
 	// Build a texture for the video frame
 	if (initFromPixels)
 	{		
-		int frame = mContext->surfaceId;
-		if (mContext->hasFrame[frame])
+		if (mContext->hasFrame())
 		{
 			if (mTexture == nullptr)
 			{
@@ -487,15 +568,29 @@ void VideoVlcComponent::render(const Transform4x4f& parentTrans)
 			// Try to limit transfert to opengl textures to 30fps to save CPU
 			if (!Settings::getInstance()->getBool("OptimizeVideo") || mElapsed >= 40) // 40ms = 25fps, 33.33 = 30 fps
 #endif
+			if (mContext->acquireFrame())
 			{
-				mContext->mutexes[frame].lock();
-				mTexture->updateFromExternalPixels(mContext->surfaces[frame], mVideoWidth, mVideoHeight);
-				mContext->hasFrame[frame] = false;
-				mContext->mutexes[frame].unlock();
+				// The read surface belongs to the render thread until the next acquireFrame : no lock needed
+				unsigned char* frame = mContext->getReadSurface();
+
+				if (!mContext->planar)
+					mTexture->updateFromExternalPixels(frame, mVideoWidth, mVideoHeight);
+				else if (canRenderPlanes())
+					updatePlaneTextures(frame);
+				else
+					updateTextureFromPlanes(frame);
 
 				mElapsed = 0;
+
+				if (mStartVideoTime != 0)
+				{
+					sTimeToFirstFrame = SDL_GetTicks() - mStartVideoTime;
+					mStartVideoTime = 0;
+				}
 			}
 		}
+
+		renderPlanes = mContext->planar && mPlaneTextures[0] != 0 && canRenderPlanes();
 	}
 
 	if (mTexture == nullptr)
@@ -544,7 +639,7 @@ void VideoVlcComponent::render(const Transform4x4f& parentTrans)
 	// for (int i = 0; i < 4; ++i)
 	//	vertices[i].pos.round();
 	
-	if (mTexture->bind())
+	if (renderPlanes || mTexture->bind())
 	{
 		Renderer::setMatrix(trans);
 
@@ -559,9 +654,16 @@ void VideoVlcComponent::render(const Transform4x4f& parentTrans)
 		if (mRoundCorners > 0 && mRoundCornerStencil.size() > 0)
 		{
 			Renderer::setStencil(mRoundCornerStencil.data(), mRoundCornerStencil.size());
-			Renderer::drawTriangleStrips(&mVertices[0], 4);
+
+			if (renderPlanes)
+				Renderer::drawYUVTriangleStrips(&mVertices[0], 4, mPlaneTextures);
+			else
+				Renderer::drawTriangleStrips(&mVertices[0], 4);
+
 			Renderer::disableStencil();
 		}
+		else if (renderPlanes)
+			Renderer::drawYUVTriangleStrips(&mVertices[0], 4, mPlaneTextures);
 		else
 		{
 			mVertices->cornerRadius = mRoundCorners < 1 ? Math::max(mSize.x(), mSize.y()) * mRoundCorners : mRoundCorners;
@@ -574,17 +676,76 @@ void VideoVlcComponent::render(const Transform4x4f& parentTrans)
 	}
 }
 
-VideoContext* VideoVlcComponent::createContext()
+bool VideoVlcComponent::canRenderPlanes()
+{
+	// The YUV shader doesn't handle saturation, custom shaders & corner radius : these frames are converted to RGBA
+	return mSaturation == 1.0f && mCustomShader.path.empty() && (mRoundCorners <= 0 || mRoundCornerStencil.size() > 0);
+}
+
+void VideoVlcComponent::updatePlaneTextures(unsigned char* planes)
+{
+	const int width = mContext->width;
+	const int height = mContext->height;
+
+	if (mPlaneTextures[0] == 0 || mPlaneTexturesSize != Vector2i(width, height))
+	{
+		releasePlaneTextures();
+
+		mPlaneTextures[0] = Renderer::createTexture(Renderer::Texture::LUMINANCE, mLinearSmooth, false, width, height, nullptr);
+		mPlaneTextures[1] = Renderer::createTexture(Renderer::Texture::LUMINANCE, true, false, width / 2, height / 2, nullptr);
+		mPlaneTextures[2] = Renderer::createTexture(Renderer::Texture::LUMINANCE, true, false, width / 2, height / 2, nullptr);
+		mPlaneTexturesSize = Vector2i(width, height);
+
+		if (mPlaneTextures[0] == 0 || mPlaneTextures[1] == 0 || mPlaneTextures[2] == 0)
+		{
+			releasePlaneTextures();
+			updateTextureFromPlanes(planes);
+			return;
+		}
+	}
+
+	unsigned char* u = planes + width * height;
+	unsigned char* v = u + (width / 2) * (height / 2);
+
+	Renderer::streamTexture(mPlaneTextures[0], Renderer::Texture::LUMINANCE, width, height, planes);
+	Renderer::streamTexture(mPlaneTextures[1], Renderer::Texture::LUMINANCE, width / 2, height / 2, u);
+	Renderer::streamTexture(mPlaneTextures[2], Renderer::Texture::LUMINANCE, width / 2, height / 2, v);
+}
+
+void VideoVlcComponent::updateTextureFromPlanes(unsigned char* planes)
+{
+	// CPU fallback : the texture keeps a pointer to the converted frame, so the buffer lives as long as the component
+	mConvertedFrame.resize(mContext->width * mContext->height * 4);
+	ImageIO::convertI420ToRGBA(planes, mContext->width, mContext->height, mConvertedFrame.data());
+	mTexture->updateFromExternalPixels(mConvertedFrame.data(), mContext->width, mContext->height);
+}
+
+void VideoVlcComponent::releasePlaneTextures()
 {
-	// Create an RGBA surface to render the video into
+	for (int i = 0; i < 3; i++)
+	{
+		if (mPlaneTextures[i] != 0)
+			Renderer::destroyTexture(mPlaneTextures[i]);
+
+		mPlaneTextures[i] = 0;
+	}
+}
+
+VideoContext* VideoVlcComponent::createContext(unsigned width, unsigned height)
+{
+	bool planar = isPlanarVideo(width);
+
+	// Create an RGBA (or I420) surface to render the video into
+	size_t surfaceSize = planar ? width * height + (width / 2) * (height / 2) * 2 : width * height * 4;
+
 	VideoContext* ctx = new VideoContext();
-	ctx->surfaces[0] = new unsigned char[mVideoWidth * mVideoHeight * 4];
-	ctx->surfaces[1] = new unsigned char[mVideoWidth * mVideoHeight * 4];
-	ctx->hasFrame[0] = false;
-	ctx->hasFrame[1] = false;
-	ctx->component = this;
+	ctx->planar = planar;
+	ctx->width = width;
+	ctx->height = height;
+	for (int i = 0; i < VIDEO_FRAME_BUFFERS; i++)
+		ctx->surfaces[i] = new unsigned char[surfaceSize];
 
-	resize();	
+	ctx->component = nullptr;
 
 	return ctx;
 }
@@ -718,7 +879,7 @@ void VideoVlcComponent::handleLooping()
 				}
 			}
 
-			if (!getPlayAudio() || (!mScreensaverMode && !Settings::getInstance()->getBool("VideoAudio")) || (Settings::getInstance()->getBool("ScreenSaverVideoMute") && mScreensaverMode))
+			if (isAudioMuted())
 				libvlc_audio_set_mute(mMediaPlayer, 1);
 
 			//libvlc_media_player_set_position(mMediaPlayer, 0.0f);
@@ -730,26 +891,24 @@ void VideoVlcComponent::handleLooping()
 	}
 }
 
-void VideoVlcComponent::onMediaParsed()
+bool VideoVlcComponent::getVideoSize(libvlc_media_t* media, const std::string& videoPath, unsigned& width, unsigned& height, bool& hasAudioTrack)
 {
-	StopWatch stopWatch("[VideoVlcComponent] onMediaParsed", LogDebug);
-
-	mVideoWidth = 0;
-	mVideoHeight = 0;
+	width = 0;
+	height = 0;
 
-	bool hasAudioTrack = false;
+	hasAudioTrack = false;
 	unsigned track_count;
 
 	libvlc_media_track_t** tracks;
-	track_count = libvlc_media_tracks_get(mMedia, &tracks);
+	track_count = libvlc_media_tracks_get(media, &tracks);
 	for (unsigned track = 0; track < track_count; ++track)
 	{
 		if (tracks[track]->i_type == libvlc_track_audio)
 			hasAudioTrack = true;
 		else if (tracks[track]->i_type == libvlc_track_video)
 		{
-			mVideoWidth = tracks[track]->video->i_width;
-			mVideoHeight = tracks[track]->video->i_height;
+			width = tracks[track]->video->i_width;
+			height = tracks[track]->video->i_height;
 
 			if (hasAudioTrack)
 				break;
@@ -757,21 +916,21 @@ void VideoVlcComponent::onMediaParsed()
 	}
 	libvlc_media_tracks_release(tracks, track_count);
 
-	if (mVideoWidth == 0 && mVideoHeight == 0 && Utils::FileSystem::isAudio(mPlayingVideoPath))
+	if (width == 0 && height == 0 && Utils::FileSystem::isAudio(videoPath))
 	{
 		if (getPlayAudio() && !mScreensaverMode && Settings::getInstance()->getBool("VideoAudio"))
 		{
 			// Make fake dimension to play audio files
-			mVideoWidth = 1;
-			mVideoHeight = 1;
+			width = 1;
+			height = 1;
 		}
 	}
 
 	// Make sure we found a valid video track
-	if (mVideoWidth <= 0 || mVideoHeight <= 0)
-		return;
+	if (width <= 0 || height <= 0)
+		return false;
 
-	if (mVideoWidth > 1 && Settings::getInstance()->getBool("OptimizeVideo"))
+	if (width > 1 && Settings::getInstance()->getBool("OptimizeVideo"))
 	{
 		// Avoid videos bigger than resolution
 		Vector2f maxSize(Renderer::getScreenWidth(), Renderer::getScreenHeight());
@@ -786,37 +945,97 @@ void VideoVlcComponent::onMediaParsed()
 			maxSize = mTargetSize;
 
 		// If video is bigger than display, ask VLC for a smaller image
-		auto sz = ImageIO::adjustPictureSize(Vector2i(mVideoWidth, mVideoHeight), Vector2i(maxSize.x(), maxSize.y()), mTargetIsMin);
-		if (sz.x() < mVideoWidth || sz.y() < mVideoHeight)
+		auto sz = ImageIO::adjustPictureSize(Vector2i(width, height), Vector2i(maxSize.x(), maxSize.y()), mTargetIsMin);
+		if (sz.x() < width || sz.y() < height)
 		{
-			mVideoWidth = sz.x();
-			mVideoHeight = sz.y();
+			width = sz.x();
+			height = sz.y();
 		}
 	}
 
-	mMediaPlayer = libvlc_media_player_new_from_media(mMedia);
+	if (isPlanarVideo(width))
+	{
+		// Chroma planes are half size : keep even dimensions
+		width = std::max(2u, width & ~1u);
+		height = std::max(2u, height & ~1u);
+	}
+
+	return true;
+}
+
+bool VideoVlcComponent::isAudioMuted()
+{
+	return !getPlayAudio() || (!mScreensaverMode && !Settings::getInstance()->getBool("VideoAudio")) || (Settings::getInstance()->getBool("ScreenSaverVideoMute") && mScreensaverMode);
+}
+
+void VideoVlcComponent::onMediaParsed()
+{
+	StopWatch stopWatch("[VideoVlcComponent] onMediaParsed", LogDebug);
+
+	bool hasAudioTrack = false;
+	if (!getVideoSize(mMedia, mPlayingVideoPath, mVideoWidth, mVideoHeight, hasAudioTrack))
+		return;
+
+	mMediaPlayer = acquireMediaPlayer(mMedia);
 	if (!mMediaPlayer)
 		return;
 
-	mContext = createContext();
+	mContext = createContext(mVideoWidth, mVideoHeight);
+	mContext->component = this;
+	resize();
 
 	if (hasAudioTrack)
 	{
-		if (!getPlayAudio() || (!mScreensaverMode && !Settings::getInstance()->getBool("VideoAudio")) || (Settings::getInstance()->getBool("ScreenSaverVideoMute") && mScreensaverMode))
+		if (isAudioMuted())
 			libvlc_audio_set_mute(mMediaPlayer, 1);
 		else
+		{
+			libvlc_audio_set_mute(mMediaPlayer, 0);
 			AudioManager::setVideoPlaying(true);
+		}
 	}
 
-	if (mVideoWidth > 1)
-	{
-		libvlc_video_set_callbacks(mMediaPlayer, lock, unlock, display, (void*)mContext);
-		libvlc_video_set_format(mMediaPlayer, "RGBA", (int)mVideoWidth, (int)mVideoHeight, (int)mVideoWidth * 4);
-	}	
-	
+	setupMediaPlayer(mMediaPlayer, mContext);
 	libvlc_media_player_play(mMediaPlayer);
 }
 
+libvlc_media_t* VideoVlcComponent::createMedia(const std::string& videoPath)
+{
+	std::string playbackPath = videoPath;
+
+	// Small boxes play a proxy transcoded at their size, once it is available
+	if (Settings::getInstance()->getBool("VideoProxies") && !mScreensaverMode && !mTargetIsMin && !mTargetSize.empty() &&
+		mTargetSize.x() * mTargetSize.y() < Renderer::getScreenWidth() * Renderer::getScreenHeight() / 2)
+	{
+		std::string proxy = VideoProxyCache::getProxy(videoPath, Vector2i(mTargetSize.x(), mTargetSize.y()));
+		if (!proxy.empty())
+			playbackPath = proxy;
+	}
+
+#ifdef WIN32
+	std::string path = Utils::String::replace(playbackPath, "/", "\\");
+#else
+	std::string path = playbackPath;
+#endif
+
+	libvlc_media_t* media = libvlc_media_new_path(mVLC, path.c_str());
+	if (!media)
+		return nullptr;
+
+	// use : vlc long-help
+	// WIN32 ? libvlc_media_add_option(mMedia, ":avcodec-hw=dxva2");
+	// RPI/OMX ? libvlc_media_add_option(mMedia, ":codec=mediacodec,iomx,all"); .
+
+	std::string options = SystemConf::getInstance()->get("vlc.options");
+	if (!options.empty())
+	{
+		for (auto token : Utils::String::split(options, ' '))
+			libvlc_media_add_option(media, token.c_str());
+	}
+
+	return media;
+}
+
 void VideoVlcComponent::startVideo()
 {
 	if (mIsPlaying || !mVLC)
@@ -830,13 +1049,12 @@ void VideoVlcComponent::startVideo()
 
 	StopWatch stopWatch("[VideoVlcComponent] startVideo", LogDebug);
 
-#ifdef WIN32
-	std::string path = Utils::String::replace(mVideoPath, "/", "\\");
-#else
-	std::string path = mVideoPath;
-#endif
+	mStartVideoTime = SDL_GetTicks();
 
-	mMedia = libvlc_media_new_path(mVLC, path.c_str());
+	PrerolledVideo prerolled;
+	bool isPrerolled = takePrerolledVideo(mVideoPath, prerolled);
+
+	mMedia = isPrerolled ? prerolled.media : createMedia(mVideoPath);
 	if (!mMedia)
 	{
 		stopVideo();
@@ -853,15 +1071,14 @@ void VideoVlcComponent::startVideo()
 
 	PowerSaver::pause();
 
-	// use : vlc long-help
-	// WIN32 ? libvlc_media_add_option(mMedia, ":avcodec-hw=dxva2");
-	// RPI/OMX ? libvlc_media_add_option(mMedia, ":codec=mediacodec,iomx,all"); .
-
-	std::string options = SystemConf::getInstance()->get("vlc.options");
-	if (!options.empty())
+	if (isPrerolled)
 	{
-		for (auto token : Utils::String::split(options, ' '))
-			libvlc_media_add_option(mMedia, token.c_str());
+		if (prerolled.player != nullptr)
+			adoptPrerolledVideo(prerolled);
+		else // Still parsing : update calls onMediaParsed when it's done
+			mIsParsing = true;
+
+		return;
 	}
 
 	// If we have a playlist : most videos have a fader, skip it 1 second
@@ -902,6 +1119,12 @@ void VideoVlcComponent::stopVideo()
 	mIsWaitingForVideoToStart = false;
 	mStartDelayed = false;
 
+	// The YUV textures are released : keep the last frame in the RGBA texture if it is still displayed
+	if (mContext != nullptr && mContext->planar && mPlaneTextures[0] != 0 && mTexture != nullptr && !mIsTopWindow)
+		updateTextureFromPlanes(mContext->getReadSurface());
+
+	releasePlaneTextures();
+
 	// Release the media player so it stops calling back to us
 	if (mMediaPlayer)
 	{
@@ -990,7 +1213,25 @@ void VideoVlcComponent::update(int deltaTime)
 	{
 		mIsParsing = false;
 		onMediaParsed();
-	}		
+	}
+
+	for (auto& video : mPrerolledVideos)
+	{
+		if (video.invalid)
+			continue;
+
+		if (video.player == nullptr)
+		{
+			if (libvlc_media_get_parsed_status(video.media) != 0)
+				startPrerolledVideo(video);
+		}
+		else if (!video.paused && video.context->hasFrame())
+		{
+			// The first frame is decoded : wait there until the video is selected
+			libvlc_media_player_set_pause(video.player, 1);
+			video.paused = true;
+		}
+	}
 	
 	VideoComponent::update(deltaTime);
 }
@@ -1004,6 +1245,147 @@ void VideoVlcComponent::onShow()
 		pauseStoryboard();
 }
 
+void VideoVlcComponent::onHide()
+{
+	releasePrerolledVideos();
+	VideoComponent::onHide();
+}
+
+void VideoVlcComponent::prerollVideos(const std::vector<std::string>& paths)
+{
+	std::vector<std::string> videos;
+
+#if LIBVLC_VERSION_MAJOR >= 3
+	if (mVLC != nullptr && !mScreensaverMode && Settings::getInstance()->getBool("VideoPreroll"))
+	{
+		for (auto path : paths)
+		{
+			std::string fullPath = Utils::FileSystem::getCanonicalPath(path);
+			if (!fullPath.empty() && fullPath != mVideoPath && videos.size() < VIDEO_PREROLL_COUNT)
+				videos.push_back(fullPath);
+		}
+	}
+#endif
+
+	// Release the videos which are not neighbours anymore. Keep the selected one, startVideo takes it
+	for (auto it = mPrerolledVideos.begin(); it != mPrerolledVideos.end(); )
+	{
+		if (it->path != mVideoPath && std::find(videos.cbegin(), videos.cend(), it->path) == videos.cend())
+		{
+			releasePrerolledVideo(*it);
+			it = mPrerolledVideos.erase(it);
+		}
+		else
+			it++;
+	}
+
+#if LIBVLC_VERSION_MAJOR >= 3
+	for (auto path : videos)
+	{
+		if (std::find_if(mPrerolledVideos.cbegin(), mPrerolledVideos.cend(), [path](const PrerolledVideo& video) { return video.path == path; }) != mPrerolledVideos.cend())
+			continue;
+
+		PrerolledVideo video;
+		video.path = path;
+		video.media = createMedia(path);
+		if (video.media == nullptr)
+			continue;
+
+		libvlc_media_parse_with_options(video.media, libvlc_media_parse_local, 0);
+		mPrerolledVideos.push_back(video);
+	}
+#endif
+}
+
+void VideoVlcComponent::startPrerolledVideo(PrerolledVideo& video)
+{
+	if (!getVideoSize(video.media, video.path, video.width, video.height, video.hasAudioTrack))
+	{
+		video.invalid = true;
+		return;
+	}
+
+	video.player = acquireMediaPlayer(video.media);
+	if (video.player == nullptr)
+	{
+		video.invalid = true;
+		return;
+	}
+
+	video.context = createContext(video.width, video.height);
+
+	setupMediaPlayer(video.player, video.context);
+	libvlc_audio_set_mute(video.player, 1);
+	libvlc_media_player_play(video.player);
+}
+
+bool VideoVlcComponent::takePrerolledVideo(const std::string& videoPath, PrerolledVideo& video)
+{
+	for (auto it = mPrerolledVideos.begin(); it != mPrerolledVideos.end(); it++)
+	{
+		if (it->path != videoPath)
+			continue;
+
+		if (it->invalid)
+		{
+			releasePrerolledVideo(*it);
+			mPrerolledVideos.erase(it);
+			return false;
+		}
+
+		video = *it;
+		mPrerolledVideos.erase(it);
+		return true;
+	}
+
+	return false;
+}
+
+void VideoVlcComponent::adoptPrerolledVideo(PrerolledVideo& video)
+{
+	mMediaPlayer = video.player;
+	mContext = video.context;
+	mVideoWidth = video.width;
+	mVideoHeight = video.height;
+
+	mContext->component = this;
+	resize();
+
+	if (video.hasAudioTrack && !isAudioMuted())
+	{
+		libvlc_audio_set_mute(mMediaPlayer, 0);
+		AudioManager::setVideoPlaying(true);
+	}
+
+	// The first frame is already there : show it now, the display callback won't be called before the next one
+	if (video.paused)
+	{
+		onVideoStarted();
+		libvlc_media_player_set_pause(mMediaPlayer, 0);
+	}
+}
+
+void VideoVlcComponent::releasePrerolledVideo(PrerolledVideo& video)
+{
+	if (video.player != nullptr)
+		mediaplayer_release_async(video.context, video.player);
+	else if (video.context != nullptr)
+		delete video.context;
+
+	if (video.media != nullptr)
+		libvlc_media_release(video.media);
+
+	video = PrerolledVideo();
+}
+
+void VideoVlcComponent::releasePrerolledVideos()
+{
+	for (auto& video : mPrerolledVideos)
+		releasePrerolledVideo(video);
+
+	mPrerolledVideos.clear();
+}
+
 ThemeData::ThemeElement::Property VideoVlcComponent::getProperty(const std::string name)
 {
 	Vector2f scale = getParent() ? getParent()->getSize() : Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
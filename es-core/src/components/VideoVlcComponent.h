@@ -5,40 +5,72 @@
 #include "VideoComponent.h"
 #include "ThemeData.h"
 #include "renderers/Renderer.h"
+#include <atomic>
 #include <mutex>
 
 struct libvlc_instance_t;
 struct libvlc_media_t;
 struct libvlc_media_player_t;
 
+#define VIDEO_FRAME_BUFFERS	3
+#define VIDEO_FRAME_READY	4
+
+// Frames go from the VLC decoder thread to the render thread through a lock-free triple buffer :
+// each side owns a surface, the third one is pending. When a side is done, it swaps its surface with the pending one.
 struct VideoContext 
 {
 	VideoContext()
 	{
-		surfaces[0] = nullptr;
-		surfaces[1] = nullptr;
+		for (int i = 0; i < VIDEO_FRAME_BUFFERS; i++)
+			surfaces[i] = nullptr;
+
 		component = nullptr;		
-		hasFrame[0] = false;
-		hasFrame[1] = false;
-		surfaceId = 0;
+		writeId = 0;
+		pendingId = 1;
+		readId = 2;
+		planar = false;
+		width = 0;
+		height = 0;
 	}
 
 	~VideoContext()
 	{
-		if (surfaces[0])
-			delete[] surfaces[0];
+		for (int i = 0; i < VIDEO_FRAME_BUFFERS; i++)
+		{
+			if (surfaces[i])
+				delete[] surfaces[i];
 
-		if (surfaces[1])
-			delete[] surfaces[1];
+			surfaces[i] = nullptr;
+		}
+	}
 
-		surfaces[0] = nullptr;
-		surfaces[1] = nullptr;
+	// Decoder side
+	unsigned char* getWriteSurface() { return surfaces[writeId]; }
+	void publishFrame() { writeId = pendingId.exchange(writeId | VIDEO_FRAME_READY) & ~VIDEO_FRAME_READY; }
+
+	// Render side
+	bool hasFrame() const { return (pendingId.load() & VIDEO_FRAME_READY) != 0; }
+	bool acquireFrame()
+	{
+		if (!hasFrame())
+			return false;
+
+		readId = pendingId.exchange(readId) & ~VIDEO_FRAME_READY;
+		return true;
 	}
 
-	int					surfaceId;
-	unsigned char*		surfaces[2];	
-	std::mutex			mutexes[2];
-	bool				hasFrame[2];
+	unsigned char* getReadSurface() { return surfaces[readId]; }
+
+	unsigned char*		surfaces[VIDEO_FRAME_BUFFERS];
+
+	int					writeId;
+	std::atomic<int>	pendingId;
+	int					readId;
+
+	// Surfaces hold I420 frames (Y, U & V planes) instead of RGBA
+	bool				planar;
+	int					width;
+	int					height;
 
 	VideoComponent*		component;	
 };
@@ -66,6 +98,22 @@ class VideoVlcComponent : public VideoComponent
 		std::string						defaultVideoPath;
 	};
 
+	// A video opened in advance & paused on its first frame, muted
+	struct PrerolledVideo
+	{
+		PrerolledVideo() : media(nullptr), player(nullptr), context(nullptr), width(0), height(0), hasAudioTrack(false), paused(false), invalid(false) { }
+
+		std::string				path;
+		libvlc_media_t*			media;
+		libvlc_media_player_t*	player;
+		VideoContext*			context;
+		unsigned				width;
+		unsigned				height;
+		bool					hasAudioTrack;
+		bool					paused;
+		bool					invalid;
+	};
+
 public:
 	static void init();
 
@@ -92,6 +140,9 @@ public:
 	void	setColorShift(unsigned int color);
 
 	virtual void onShow() override;
+	virtual void onHide() override;
+
+	void prerollVideos(const std::vector<std::string>& paths) override;
 
 	ThemeData::ThemeElement::Property getProperty(const std::string name) override;
 	void setProperty(const std::string name, const ThemeData::ThemeElement::Property& value) override;
@@ -127,7 +178,22 @@ private:
 
 	virtual void onVideoStarted();
 
-	VideoContext* createContext();
+	VideoContext* createContext(unsigned width, unsigned height);
+
+	libvlc_media_t* createMedia(const std::string& videoPath);
+	bool getVideoSize(libvlc_media_t* media, const std::string& videoPath, unsigned& width, unsigned& height, bool& hasAudioTrack);
+	bool isAudioMuted();
+
+	void startPrerolledVideo(PrerolledVideo& video);
+	bool takePrerolledVideo(const std::string& videoPath, PrerolledVideo& video);
+	void adoptPrerolledVideo(PrerolledVideo& video);
+	void releasePrerolledVideo(PrerolledVideo& video);
+	void releasePrerolledVideos();
+
+	bool canRenderPlanes();
+	void updatePlaneTextures(unsigned char* planes);
+	void releasePlaneTextures();
+	void updateTextureFromPlanes(unsigned char* planes);
 
 	void onMediaParsed();
 	bool mIsParsing;
@@ -141,6 +207,13 @@ private:
 	VideoContext*					mContext;
 	std::shared_ptr<TextureResource> mTexture;
 
+	unsigned int					mPlaneTextures[3];
+	Vector2i						mPlaneTexturesSize;
+	std::vector<unsigned char>		mConvertedFrame;
+
+	std::vector<PrerolledVideo>		mPrerolledVideos;
+	unsigned						mStartVideoTime;
+
 	std::string					    mSubtitlePath;
 	std::string					    mSubtitleTmpFile;
 	Renderer::ShaderInfo			mCustomShader;
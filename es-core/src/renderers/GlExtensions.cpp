@@ -42,6 +42,10 @@ namespace glext
 
 	PFNGLGETACTIVEUNIFORMPROC glGetActiveUniform = nullptr;
 
+	PFNGLDELETEBUFFERSPROC glDeleteBuffers = nullptr;
+	PFNGLMAPBUFFERPROC glMapBuffer = nullptr;
+	PFNGLUNMAPBUFFERPROC glUnmapBuffer = nullptr;
+
 	void* _glProcAddress(const char *proc)
 	{
 		void* ret = SDL_GL_GetProcAddress(proc);
@@ -114,6 +118,13 @@ namespace glext
 
 		glGetActiveUniform = (PFNGLGETACTIVEUNIFORMPROC)_glProcAddress("glGetActiveUniform");
 
+		if (SDL_GL_ExtensionSupported("GL_ARB_pixel_buffer_object"))
+		{
+			glDeleteBuffers = (PFNGLDELETEBUFFERSPROC)_glProcAddress("glDeleteBuffers");
+			glMapBuffer = (PFNGLMAPBUFFERPROC)_glProcAddress("glMapBuffer");
+			glUnmapBuffer = (PFNGLUNMAPBUFFERPROC)_glProcAddress("glUnmapBuffer");
+		}
+
 		return 
 			glCreateShader != nullptr && glCompileShader != nullptr && glCreateProgram != nullptr && glGenBuffers != nullptr && 
 			glBindBuffer != nullptr && glGetShaderiv != nullptr && glGetShaderInfoLog != nullptr && glAttachShader != nullptr &&
@@ -122,6 +133,11 @@ namespace glext
 			glVertexAttribPointer != nullptr && glBufferData != nullptr && glBufferSubData != nullptr && glVertexAttribPointer != nullptr && glEnableVertexAttribArray != nullptr &&
 			glDisableVertexAttribArray != nullptr && glUniformMatrix4fv != nullptr && glActiveTexture_ != nullptr && glUniform1f != nullptr && glUniform2f != nullptr && glDeleteShader != nullptr && glDeleteProgram != nullptr;
 	}
+
+	bool supportPixelBuffers()
+	{
+		return glDeleteBuffers != nullptr && glMapBuffer != nullptr && glUnmapBuffer != nullptr;
+	}
 }
 #endif
 
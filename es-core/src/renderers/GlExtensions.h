@@ -48,6 +48,13 @@ namespace glext
 	extern PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers;		
 
 	extern PFNGLGETACTIVEUNIFORMPROC glGetActiveUniform;
+
+	// Optional : pixel buffer objects
+	extern PFNGLDELETEBUFFERSPROC glDeleteBuffers;
+	extern PFNGLMAPBUFFERPROC glMapBuffer;
+	extern PFNGLUNMAPBUFFERPROC glUnmapBuffer;
+
+	bool supportPixelBuffers();
 };
 
 using namespace glext;
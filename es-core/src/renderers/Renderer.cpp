@@ -957,6 +957,11 @@ namespace Renderer
 		Instance()->bindTexture(_texture);
 	}
 
+	void streamTexture(const unsigned int _texture, const Texture::Type _type, const unsigned int _width, const unsigned int _height, void* _data)
+	{
+		Instance()->streamTexture(_texture, _type, _width, _height, _data);
+	}
+
 	void drawLines(const Vertex* _vertices, const unsigned int _numVertices, const Blend::Factor _srcBlendFactor, const Blend::Factor _dstBlendFactor)
 	{
 		Instance()->drawLines(_vertices, _numVertices, _srcBlendFactor, _dstBlendFactor);
@@ -982,11 +987,26 @@ namespace Renderer
 		return Instance()->shaderSupportsCornerSize(shader);
 	}
 
+	bool shaderIsAnimated(const std::string& shader)
+	{
+		return Instance()->shaderIsAnimated(shader);
+	}
+
 	bool supportShaders()
 	{
 		return Instance()->supportShaders();
 	}
 
+	bool supportYUVTextures()
+	{
+		return Instance()->supportYUVTextures();
+	}
+
+	void drawYUVTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const unsigned int* _planes)
+	{
+		Instance()->drawYUVTriangleStrips(_vertices, _numVertices, _planes);
+	}
+
 	void setProjection(const Transform4x4f& _projection)
 	{
 		Instance()->setProjection(_projection);
@@ -38,7 +38,9 @@ namespace Renderer
 		enum Type
 		{
 			RGBA  = 0,
-			ALPHA = 1
+			ALPHA = 1,
+			DISTANCE_FIELD = 2, // ALPHA texture holding a signed distance field, needs shaders
+			LUMINANCE = 3 // Single channel texture, used for the planes of YUV video frames
 
 		}; // Type
 
@@ -116,6 +118,9 @@ namespace Renderer
 		virtual void         updateTexture(const unsigned int _texture, const Texture::Type _type, const unsigned int _x, const unsigned _y, const unsigned int _width, const unsigned int _height, void* _data) = 0;
 		virtual void         bindTexture(const unsigned int _texture) = 0;
 
+		// Replaces the whole content of a texture which changes every frame (video frames)
+		virtual void         streamTexture(const unsigned int _texture, const Texture::Type _type, const unsigned int _width, const unsigned int _height, void* _data) { updateTexture(_texture, _type, 0, 0, _width, _height, _data); }
+
 		virtual void         drawLines(const Vertex* _vertices, const unsigned int _numVertices, const Blend::Factor _srcBlendFactor = Blend::SRC_ALPHA, const Blend::Factor _dstBlendFactor = Blend::ONE_MINUS_SRC_ALPHA) = 0;
 		virtual void         drawTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const Blend::Factor _srcBlendFactor = Blend::SRC_ALPHA, const Blend::Factor _dstBlendFactor = Blend::ONE_MINUS_SRC_ALPHA, bool verticesChanged = true) = 0;
 		virtual void		 drawTriangleFan(const Vertex* _vertices, const unsigned int _numVertices, const Blend::Factor _srcBlendFactor = Blend::SRC_ALPHA, const Blend::Factor _dstBlendFactor = Blend::ONE_MINUS_SRC_ALPHA) = 0;
@@ -139,6 +144,11 @@ namespace Renderer
 
 		virtual bool		 supportShaders() { return false; }
 		virtual bool		 shaderSupportsCornerSize(const std::string& shader) { return false; };
+		virtual bool		 shaderIsAnimated(const std::string& shader) { return false; };
+
+		// Draws Y, U & V LUMINANCE textures (I420 planes), converted to RGB by a shader
+		virtual bool		 supportYUVTextures() { return false; }
+		virtual void		 drawYUVTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const unsigned int* _planes) { };
 	};
 	
 	class ScreenSettings
@@ -192,6 +202,7 @@ namespace Renderer
 	void         destroyTexture    (const unsigned int _texture);
 	void         updateTexture     (const unsigned int _texture, const Texture::Type _type, const unsigned int _x, const unsigned _y, const unsigned int _width, const unsigned int _height, void* _data);
 	void         bindTexture       (const unsigned int _texture);
+	void         streamTexture     (const unsigned int _texture, const Texture::Type _type, const unsigned int _width, const unsigned int _height, void* _data);
 	void         drawLines         (const Vertex* _vertices, const unsigned int _numVertices, const Blend::Factor _srcBlendFactor = Blend::SRC_ALPHA, const Blend::Factor _dstBlendFactor = Blend::ONE_MINUS_SRC_ALPHA);
 	void         drawTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const Blend::Factor _srcBlendFactor = Blend::SRC_ALPHA, const Blend::Factor _dstBlendFactor = Blend::ONE_MINUS_SRC_ALPHA, bool verticesChanged = true);
 	void		 drawSolidRectangle(const float _x, const float _y, const float _w, const float _h, const unsigned int _fillColor, const unsigned int _borderColor, float borderWidth = 1, float cornerRadius = 0);
@@ -210,6 +221,10 @@ namespace Renderer
 
 	bool		 supportShaders();
 	bool		 shaderSupportsCornerSize(const std::string& shader);
+	bool		 shaderIsAnimated(const std::string& shader);
+
+	bool		 supportYUVTextures();
+	void		 drawYUVTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const unsigned int* _planes);
 
 	std::string  getDriverName();
 	std::vector<std::pair<std::string, std::string>> getDriverInformation();
@@ -45,6 +45,8 @@ namespace Renderer
 		{
 			case Texture::RGBA:  { return GL_RGBA;  } break;
 			case Texture::ALPHA: { return GL_ALPHA; } break;
+			case Texture::DISTANCE_FIELD: { return GL_ALPHA; } break;
+			case Texture::LUMINANCE: { return GL_LUMINANCE; } break;
 			default:             { return GL_ZERO;  }
 		}
 
@@ -26,8 +26,11 @@ namespace Renderer
 
 	struct TextureInfo
 	{
+		TextureInfo() : distanceField(false) { }
+
 		GLenum type;
 		Vector2f size;
+		bool distanceField;
 	};
 
 	static SDL_GLContext	sdlContext       = nullptr;
@@ -39,10 +42,13 @@ namespace Renderer
 	static ShaderProgram    shaderProgramColorTexture;
 	static ShaderProgram    shaderProgramColorNoTexture;
 	static ShaderProgram    shaderProgramAlpha;
+	static ShaderProgram    shaderProgramDistanceField;
+	static ShaderProgram    shaderProgramYUV;
 
 	static GLuint			vertexBuffer     = 0;
 
 	static std::map<unsigned int, TextureInfo*> _textures;
+	static std::map<unsigned int, GLuint> _pixelBuffers;
 
 	static unsigned int		boundTexture = 0;
 	static unsigned int		mShaderTexture = 0;	
@@ -357,6 +363,75 @@ namespace Renderer
 		auto fragmentShaderAlpha = Shader::createShader(GL_FRAGMENT_SHADER, fragmentSourceAlpha);
 
 		shaderProgramAlpha.createShaderProgram(vertexShaderAlpha, fragmentShaderAlpha);
+
+		// fragment shader (signed distance field text)
+		// Without derivatives, the smoothing width matches glyphs drawn around their base size
+		std::string fragmentSourceDistanceField =
+			SHADER_VERSION_STRING +
+			R"=====(
+			#ifdef GL_ES
+			#ifdef GL_OES_standard_derivatives
+			#extension GL_OES_standard_derivatives : enable
+			#define HAS_DERIVATIVES
+			#endif
+			precision mediump float;
+			precision mediump sampler2D;
+			#else
+			#define HAS_DERIVATIVES
+			#endif
+
+			varying   vec4      v_col;
+			varying   vec2      v_tex;
+			uniform   sampler2D u_tex;
+
+			void main(void)
+			{
+			    float dist = texture2D(u_tex, v_tex).a;
+			#ifdef HAS_DERIVATIVES
+			    float width = clamp(fwidth(dist) * 0.75, 0.001, 0.5);
+			#else
+			    float width = 0.07;
+			#endif
+			    float alpha = smoothstep(0.5 - width, 0.5 + width, dist);
+			    gl_FragColor = vec4(v_col.rgb, v_col.a * alpha);
+			}
+			)=====";
+
+		auto vertexShaderDistanceField = Shader::createShader(GL_VERTEX_SHADER, vertexSourceTexture);
+		auto fragmentShaderDistanceField = Shader::createShader(GL_FRAGMENT_SHADER, fragmentSourceDistanceField);
+
+		shaderProgramDistanceField.createShaderProgram(vertexShaderDistanceField, fragmentShaderDistanceField);
+
+		// fragment shader (I420 video frames : Y, U & V planes in 3 LUMINANCE textures, BT.601 limited range)
+		std::string fragmentSourceYUV =
+			SHADER_VERSION_STRING +
+			R"=====(
+			#ifdef GL_ES
+			precision mediump float;
+			precision mediump sampler2D;
+			#endif
+
+			varying   vec4      v_col;
+			varying   vec2      v_tex;
+			uniform   sampler2D u_tex;
+			uniform   sampler2D u_texU;
+			uniform   sampler2D u_texV;
+
+			void main(void)
+			{
+			    float y = 1.164 * (texture2D(u_tex, v_tex).r - 0.0625);
+			    float u = texture2D(u_texU, v_tex).r - 0.5;
+			    float v = texture2D(u_texV, v_tex).r - 0.5;
+
+			    vec3 rgb = vec3(y + 1.596 * v, y - 0.392 * u - 0.813 * v, y + 2.017 * u);
+			    gl_FragColor = vec4(clamp(rgb, 0.0, 1.0), 1.0) * v_col;
+			}
+			)=====";
+
+		auto vertexShaderYUV = Shader::createShader(GL_VERTEX_SHADER, vertexSourceTexture);
+		auto fragmentShaderYUV = Shader::createShader(GL_FRAGMENT_SHADER, fragmentSourceYUV);
+
+		shaderProgramYUV.createShaderProgram(vertexShaderYUV, fragmentShaderYUV);
 		
 		useProgram(nullptr);
 
@@ -401,9 +476,12 @@ namespace Renderer
 			case Texture::RGBA:  { return GL_RGBA;            } break;
 #if defined(USE_OPENGLES_20)
 			case Texture::ALPHA: { return GL_ALPHA; } break;
+			case Texture::DISTANCE_FIELD: { return GL_ALPHA; } break;
 #else
 			case Texture::ALPHA: { return GL_LUMINANCE_ALPHA; } break;
+			case Texture::DISTANCE_FIELD: { return GL_LUMINANCE_ALPHA; } break;
 #endif
+			case Texture::LUMINANCE: { return GL_LUMINANCE; } break;
 			default:             { return GL_ZERO;            }
 		}
 
@@ -718,12 +796,14 @@ namespace Renderer
 			{
 				it->second->type = type;
 				it->second->size = Vector2f(_width, _height);
+				it->second->distanceField = (_type == Texture::DISTANCE_FIELD);
 			}
 			else
 			{
 				auto info = new TextureInfo();
 				info->type = type;
 				info->size = Vector2f(_width, _height);
+				info->distanceField = (_type == Texture::DISTANCE_FIELD);
 				_textures[texture] = info;
 			}
 		}
@@ -747,6 +827,15 @@ namespace Renderer
 				
 			_textures.erase(it);
 		}
+
+#if OPENGL_EXTENSIONS
+		auto pbo = _pixelBuffers.find(_texture);
+		if (pbo != _pixelBuffers.cend())
+		{
+			GL_CHECK_ERROR(glDeleteBuffers(1, &pbo->second));
+			_pixelBuffers.erase(pbo);
+		}
+#endif
 		
 		GL_CHECK_ERROR(glDeleteTextures(1, &_texture));
 
@@ -800,6 +889,47 @@ namespace Renderer
 
 	} // updateTexture
 
+//////////////////////////////////////////////////////////////////////////
+
+	void GLES20Renderer::streamTexture(const unsigned int _texture, const Texture::Type _type, const unsigned int _width, const unsigned int _height, void* _data)
+	{
+#if OPENGL_EXTENSIONS
+		const GLenum type = convertTextureType(_type);
+
+		if (_data != nullptr && (type == GL_RGBA || type == GL_LUMINANCE) && supportPixelBuffers())
+		{
+			const size_t size = _width * _height * (type == GL_RGBA ? 4 : 1);
+
+			GLuint& buffer = _pixelBuffers[_texture];
+			if (buffer == 0)
+				GL_CHECK_ERROR(glGenBuffers(1, &buffer));
+
+			GL_CHECK_ERROR(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer));
+
+			// Orphan the previous storage : the driver gives a new one if the GPU still reads the last frame
+			GL_CHECK_ERROR(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+
+			void* mapped = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+			if (mapped != nullptr)
+			{
+				memcpy(mapped, _data, size);
+				glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+				// Data is now an offset in the bound buffer : glTexSubImage2D returns without waiting for the transfer
+				updateTexture(_texture, _type, 0, 0, _width, _height, nullptr);
+
+				GL_CHECK_ERROR(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+				return;
+			}
+
+			GL_CHECK_ERROR(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+		}
+#endif
+
+		updateTexture(_texture, _type, 0, 0, _width, _height, _data);
+
+	} // streamTexture
+
 //////////////////////////////////////////////////////////////////////////
 
 	void GLES20Renderer::bindTexture(const unsigned int _texture)
@@ -907,7 +1037,9 @@ namespace Renderer
 		if (boundTexture != 0)
 		{
 			auto it = _textures.find(boundTexture);
-			if (it != _textures.cend() && it->second != nullptr && it->second->type == GL_ALPHA)
+			if (it != _textures.cend() && it->second != nullptr && it->second->distanceField)
+				useProgram(&shaderProgramDistanceField);
+			else if (it != _textures.cend() && it->second != nullptr && it->second->type == GL_ALPHA)
 				useProgram(&shaderProgramAlpha);
 			else
 			{
@@ -974,6 +1106,45 @@ namespace Renderer
 
 	} // drawTriangleStrips
 
+//////////////////////////////////////////////////////////////////////////
+
+	static void setActiveTexture(GLenum _unit)
+	{
+#if OPENGL_EXTENSIONS
+		GL_CHECK_ERROR(glActiveTexture_(_unit));
+#else
+		GL_CHECK_ERROR(glActiveTexture(_unit));
+#endif
+	}
+
+	void GLES20Renderer::drawYUVTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const unsigned int* _planes)
+	{
+		GL_CHECK_ERROR(glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * _numVertices, _vertices, GL_DYNAMIC_DRAW));
+
+		// Y on the regular unit, U & V on units 1 & 2
+		bindTexture(_planes[0]);
+
+		setActiveTexture(GL_TEXTURE1);
+		GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, _planes[1]));
+		setActiveTexture(GL_TEXTURE2);
+		GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, _planes[2]));
+		setActiveTexture(GL_TEXTURE0);
+
+		useProgram(&shaderProgramYUV);
+
+		GL_CHECK_ERROR(glEnable(GL_BLEND));
+		GL_CHECK_ERROR(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+		GL_CHECK_ERROR(glDrawArrays(GL_TRIANGLE_STRIP, 0, _numVertices));
+		GL_CHECK_ERROR(glDisable(GL_BLEND));
+
+		setActiveTexture(GL_TEXTURE1);
+		GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, 0));
+		setActiveTexture(GL_TEXTURE2);
+		GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, 0));
+		setActiveTexture(GL_TEXTURE0);
+
+	} // drawYUVTriangleStrips
+
 //////////////////////////////////////////////////////////////////////////
 
 	void GLES20Renderer::setProjection(const Transform4x4f& _projection)
@@ -1063,7 +1234,9 @@ namespace Renderer
 		if (boundTexture != 0)
 		{
 			auto it = _textures.find(boundTexture);
-			if (it != _textures.cend() && it->second != nullptr && it->second->type == GL_ALPHA)
+			if (it != _textures.cend() && it->second != nullptr && it->second->distanceField)
+				useProgram(&shaderProgramDistanceField);
+			else if (it != _textures.cend() && it->second != nullptr && it->second->type == GL_ALPHA)
 				useProgram(&shaderProgramAlpha);
 			else
 			{
@@ -1131,7 +1304,7 @@ namespace Renderer
 		{
 			if (tex.first != 0 && tex.second)
 			{
-				size_t size = tex.second->size.x() * tex.second->size.y() * (tex.second->type == GL_ALPHA ? 1 : 4);
+				size_t size = tex.second->size.x() * tex.second->size.y() * (tex.second->type == GL_ALPHA || tex.second->type == GL_LUMINANCE ? 1 : 4);
 				total += size;
 			}
 		}	
@@ -1148,6 +1321,13 @@ namespace Renderer
 		return customShader->supportsCornerRadius();
 	}
 
+	bool GLES20Renderer::shaderIsAnimated(const std::string& shader)
+	{
+		// Shaders using FrameCount change on every frame
+		ShaderProgram* customShader = getShaderProgram(shader.c_str());
+		return customShader != nullptr && customShader->isAnimated();
+	}
+
 	void GLES20Renderer::postProcessShader(const std::string& path, const float _x, const float _y, const float _w, const float _h, const std::map<std::string, std::string>& parameters, unsigned int* data)
 	{
 #if OPENGL_EXTENSIONS
@@ -33,6 +33,7 @@ namespace Renderer
 		void         destroyTexture(const unsigned int _texture) override;
 		void         updateTexture(const unsigned int _texture, const Texture::Type _type, const unsigned int _x, const unsigned _y, const unsigned int _width, const unsigned int _height, void* _data) override;
 		void         bindTexture(const unsigned int _texture) override;
+		void         streamTexture(const unsigned int _texture, const Texture::Type _type, const unsigned int _width, const unsigned int _height, void* _data) override;
 
 		void         drawLines(const Vertex* _vertices, const unsigned int _numVertices, const Blend::Factor _srcBlendFactor = Blend::SRC_ALPHA, const Blend::Factor _dstBlendFactor = Blend::ONE_MINUS_SRC_ALPHA) override;
 		void         drawTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const Blend::Factor _srcBlendFactor = Blend::SRC_ALPHA, const Blend::Factor _dstBlendFactor = Blend::ONE_MINUS_SRC_ALPHA, bool verticesChanged = true) override;
@@ -56,6 +57,10 @@ namespace Renderer
 
 		bool		 supportShaders() { return true; }
 		bool		 shaderSupportsCornerSize(const std::string& shader) override;
+		bool		 shaderIsAnimated(const std::string& shader) override;
+
+		bool		 supportYUVTextures() override { return true; }
+		void		 drawYUVTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const unsigned int* _planes) override;
 
 	private:
 		unsigned int mFrameBuffer;
@@ -296,6 +296,16 @@ namespace Renderer
 			GL_CHECK_ERROR(glUseProgram(mId));
 			GL_CHECK_ERROR(glUniform1i(texUniform, 0));
 		}
+
+		// Chroma planes of YUV textures are bound on units 1 & 2
+		GLint texUUniform = glGetUniformLocation(mId, "u_texU");
+		GLint texVUniform = glGetUniformLocation(mId, "u_texV");
+		if (texUUniform != -1 && texVUniform != -1)
+		{
+			GL_CHECK_ERROR(glUseProgram(mId));
+			GL_CHECK_ERROR(glUniform1i(texUUniform, 1));
+			GL_CHECK_ERROR(glUniform1i(texVUniform, 2));
+		}
 	}
 
 	void ShaderProgram::setMatrix(Transform4x4f& mvpMatrix)
@@ -59,6 +59,7 @@ namespace Renderer
 
 		bool supportsTextureSize() { return mTextureSize != -1; }
 		bool supportsCornerRadius() { return mCornerRadius != -1; }
+		bool isAnimated() { return mFrameCount != -1; }
 
 		void deleteProgram();
 
@@ -12,6 +12,8 @@
 #include "Settings.h"
 #include "ImageIO.h"
 #include <algorithm>
+#include <math.h>
+#include <string.h>
 #include "math/Transform4x4f.h"
 
 #ifdef WIN32
@@ -23,6 +25,7 @@ FT_Library Font::sLibrary = NULL;
 int Font::getSize() const { return mSize; }
 
 std::map< std::pair<std::string, int>, std::weak_ptr<Font> > Font::sFontMap;
+std::map<std::string, std::weak_ptr<Font::DistanceFieldAtlas>> Font::sDistanceFieldAtlases;
 static std::map<unsigned int, std::string> substituableChars;
 
 Font::FontFace::FontFace(ResourceData&& d, int size) : data(d)
@@ -62,6 +65,10 @@ size_t Font::getMemoryUsage() const
 	for(auto it = mFaceCache.cbegin(); it != mFaceCache.cend(); it++)
 		memUsage += it->second->data.length;
 
+	// distance field pages are shared between all the sizes of the font
+	if (mDistanceField != nullptr)
+		memUsage += mDistanceField->getMemoryUsage() / mDistanceField.use_count();
+
 	return memUsage;
 }
 
@@ -85,6 +92,33 @@ size_t Font::getTotalMemoryUsage()
 	return total;
 }
 
+static std::vector<std::string> getFallbackFontPaths()
+{
+	std::vector<std::string> fallbackFonts = 
+	{
+		":/fontawesome-webfont.ttf",
+		":/DroidSansFallbackFull.ttf",// japanese, chinese, present on Debian
+		":/PyeojinGothic-Medium.ttf", // korean font		
+		":/Vazirmatn-Regular.ttf", // arabic
+		":/Rubik-Regular.ttf" // hebrew (https://fontmeme.com/polices/police-rubik-hebrew public domain)
+	};
+
+	std::vector<std::string> paths;
+
+	for (auto font : fallbackFonts)
+		if (ResourceManager::getInstance()->fileExists(font))
+			paths.push_back(font);
+
+	paths.shrink_to_fit();
+	return paths;
+}
+
+static const std::vector<std::string>& getFallbackFonts()
+{
+	static const std::vector<std::string> fallbackFonts = getFallbackFontPaths();
+	return fallbackFonts;
+}
+
 Font::Font(int size, const std::string& path, bool menuScaling) : mSize(size), mPath(path)
 {
 	mSize = size;
@@ -107,10 +141,37 @@ Font::Font(int size, const std::string& path, bool menuScaling) : mSize(size), m
 	for (unsigned int i = 0; i < 255; i++)
 		mGlyphCacheArray[i] = NULL;
 
+	mFaceSize = mSize;
+
+	if (Settings::getInstance()->getBool("FontDistanceField") && Renderer::supportShaders())
+	{
+		mFaceSize = FONT_DISTANCE_FIELD_SIZE;
+
+		auto it = sDistanceFieldAtlases.find(mPath);
+		if (it != sDistanceFieldAtlases.cend() && !it->second.expired())
+			mDistanceField = it->second.lock();
+		else
+		{
+			mDistanceField = std::make_shared<DistanceFieldAtlas>();
+			sDistanceFieldAtlases[mPath] = mDistanceField;
+		}
+
+		// this font is loaded
+		mDistanceField->reload();
+	}
+
+	mGlyphCache = GlyphCache::get(mPath, getFallbackFonts(), mFaceSize);
+
 	// always initialize ASCII characters
 	for(unsigned int i = 32; i < 128; i++)
 		getGlyph(i);
 
+	// pre-warm the glyphs of the theme & language from the cache, so they're not created while drawing
+	// the least recent first, as each glyph found moves to the front of the cache
+	auto prewarm = mGlyphCache->getCodepoints(128, FONT_PREWARM_GLYPHS);
+	for (auto it = prewarm.crbegin(); it != prewarm.crend(); ++it)
+		getGlyph(*it);
+
 	clearFaceCache();
 }
 
@@ -144,6 +205,9 @@ bool Font::unload()
 		for (auto tex : mTextures)
 			tex->deinitTexture();
 
+		if (mDistanceField != nullptr)
+			mDistanceField->unload();
+
 		clearFaceCache();
 
 		mLoaded = false;
@@ -178,6 +242,7 @@ Font::FontTexture::FontTexture()
 {
 	textureId = 0;
 	textureSize = Vector2i(2048, 512);
+	type = Renderer::Texture::ALPHA;
 	writePos = Vector2i::Zero();
 	rowHeight = 0;
 }
@@ -219,7 +284,7 @@ void Font::FontTexture::initTexture()
 {
 	if (textureId == 0)
 	{
-		textureId = Renderer::createTexture(Renderer::Texture::ALPHA, true, false, textureSize.x(), textureSize.y(), nullptr);
+		textureId = Renderer::createTexture(type, true, false, textureSize.x(), textureSize.y(), nullptr);
 		if (textureId == 0)
 			LOG(LogError) << "FontTexture::initTexture() failed to create texture " << textureSize.x() << "x" << textureSize.y();
 	}
@@ -271,34 +336,13 @@ void Font::getTextureForNewGlyph(const Vector2i& glyphSize, FontTexture*& tex_ou
 	}
 }
 
-std::vector<std::string> getFallbackFontPaths()
-{
-	std::vector<std::string> fallbackFonts = 
-	{
-		":/fontawesome-webfont.ttf",
-		":/DroidSansFallbackFull.ttf",// japanese, chinese, present on Debian
-		":/PyeojinGothic-Medium.ttf", // korean font		
-		":/Vazirmatn-Regular.ttf", // arabic
-		":/Rubik-Regular.ttf" // hebrew (https://fontmeme.com/polices/police-rubik-hebrew public domain)
-	};
-
-	std::vector<std::string> paths;
-
-	for (auto font : fallbackFonts)
-		if (ResourceManager::getInstance()->fileExists(font))
-			paths.push_back(font);
-
-	paths.shrink_to_fit();
-	return paths;
-}
-
 #if defined(WIN32) || defined(X86) || defined(X86_64)
 static std::map<std::string, ResourceData> globalTTFCache;
 #endif
 
 FT_Face Font::getFaceForChar(unsigned int id)
 {
-	static const std::vector<std::string> fallbackFonts = getFallbackFontPaths();
+	const std::vector<std::string>& fallbackFonts = getFallbackFonts();
 
 	// look through our current font + fallback fonts to see if any have the glyph we're looking for
 	for(unsigned int i = 0; i < fallbackFonts.size() + 1; i++)
@@ -323,10 +367,10 @@ FT_Face Font::getFaceForChar(unsigned int id)
 			if (itCache == globalTTFCache.cend())
 				continue;
 
-			mFaceCache[i] = std::unique_ptr<FontFace>(new FontFace(std::move(itCache->second), mSize));
+			mFaceCache[i] = std::unique_ptr<FontFace>(new FontFace(std::move(itCache->second), mFaceSize));
 #else
 			ResourceData data = ResourceManager::getInstance()->getFileData(path);
-			mFaceCache[i] = std::unique_ptr<FontFace>(new FontFace(std::move(data), mSize));
+			mFaceCache[i] = std::unique_ptr<FontFace>(new FontFace(std::move(data), mFaceSize));
 #endif
 			fit = mFaceCache.find(i);
 		}
@@ -368,52 +412,59 @@ Font::Glyph* Font::getGlyph(unsigned int id)
 	}
 
 	// nope, need to make a glyph
-	FT_Face face = getFaceForChar(id);
-	if(!face)
-	{
-		LOG(LogError) << "Could not find appropriate font face for character " << id << " for font " << mPath;
+	GlyphCache::Entry cached;
+	if (!mGlyphCache->find(id, cached) && !rasterizeGlyph(id, cached))
 		return NULL;
-	}
 
-	FT_GlyphSlot g = face->glyph;
+	const GlyphCache::Entry* g = &cached;
 
-	if(FT_Load_Char(face, id, FT_LOAD_RENDER))
+	Glyph* pGlyph = NULL;
+	int glyphHeight = 0;
+
+	if (mDistanceField != nullptr)
 	{
-		LOG(LogError) << "Could not find glyph for character " << id << " for font " << mPath << ", size " << mSize << "!";
-		return NULL;
+		pGlyph = createDistanceFieldGlyph(id, g);
+		if (pGlyph == NULL)
+			return NULL;
+
+		glyphHeight = (int)Math::round(g->size.y() * (float)mSize / (float)FONT_DISTANCE_FIELD_SIZE);
 	}
+	else
+	{
+		Vector2i glyphSize = g->size;
 
-	Vector2i glyphSize(g->bitmap.width, g->bitmap.rows);
+		FontTexture* tex = NULL;
+		Vector2i cursor;
+		getTextureForNewGlyph(glyphSize, tex, cursor);
 
-	FontTexture* tex = NULL;
-	Vector2i cursor;
-	getTextureForNewGlyph(glyphSize, tex, cursor);
+		// getTextureForNewGlyph can fail if the glyph is bigger than the max texture size (absurdly large font size)
+		if (tex == NULL)
+		{
+			LOG(LogError) << "Could not create glyph for character " << id << " for font " << mPath << ", size " << mSize << " (no suitable texture found)!";
+			return NULL;
+		}
 
-	// getTextureForNewGlyph can fail if the glyph is bigger than the max texture size (absurdly large font size)
-	if(tex == NULL)
-	{
-		LOG(LogError) << "Could not create glyph for character " << id << " for font " << mPath << ", size " << mSize << " (no suitable texture found)!";
-		return NULL;
-	}
+		// create glyph
+		pGlyph = new Glyph();
 
-	// create glyph
-	Glyph* pGlyph = new Glyph();
-	
-	pGlyph->texture = tex;
-	pGlyph->texPos = Vector2f((float)cursor.x() / (float)tex->textureSize.x(), (float)cursor.y() / (float)tex->textureSize.y());
-	pGlyph->texSize = Vector2f((float)glyphSize.x() / (float)tex->textureSize.x(), (float)glyphSize.y() / (float)tex->textureSize.y());
-	pGlyph->advance = Vector2f((float)g->metrics.horiAdvance / 64.0f, (float)g->metrics.vertAdvance / 64.0f);
-	pGlyph->bearing = Vector2f((float)g->metrics.horiBearingX / 64.0f, (float)g->metrics.horiBearingY / 64.0f);	
-	pGlyph->cursor = cursor;
-	pGlyph->glyphSize = glyphSize;
-
-	// upload glyph bitmap to texture
-	if (glyphSize.x() > 0 && glyphSize.y() > 0)
-		Renderer::updateTexture(tex->textureId, Renderer::Texture::ALPHA, cursor.x(), cursor.y(), glyphSize.x(), glyphSize.y(), g->bitmap.buffer);
+		pGlyph->texture = tex;
+		pGlyph->texPos = Vector2f((float)cursor.x() / (float)tex->textureSize.x(), (float)cursor.y() / (float)tex->textureSize.y());
+		pGlyph->texSize = Vector2f((float)glyphSize.x() / (float)tex->textureSize.x(), (float)glyphSize.y() / (float)tex->textureSize.y());
+		pGlyph->advance = g->advance;
+		pGlyph->bearing = g->bearing;
+		pGlyph->cursor = cursor;
+		pGlyph->glyphSize = glyphSize;
+
+		// upload glyph bitmap to texture
+		if (glyphSize.x() > 0 && glyphSize.y() > 0)
+			Renderer::updateTexture(tex->textureId, Renderer::Texture::ALPHA, cursor.x(), cursor.y(), glyphSize.x(), glyphSize.y(), (void*)g->bitmap.data());
+
+		glyphHeight = glyphSize.y();
+	}
 
 	// update max glyph height - Limit to ascii table. If we don't it can take in the fallback fonts
-	if (glyphSize.y() > mMaxGlyphHeight && id >= 32 && id < 128)
-		mMaxGlyphHeight = glyphSize.y();
+	if (glyphHeight > mMaxGlyphHeight && id >= 32 && id < 128)
+		mMaxGlyphHeight = glyphHeight;
 
 	mGlyphMap[id] = pGlyph;
 
@@ -427,27 +478,299 @@ Font::Glyph* Font::getGlyph(unsigned int id)
 // completely recreate the texture data for all textures based on mGlyphs information
 void Font::rebuildTextures()
 {
+	if (mDistanceField != nullptr)
+	{
+		mDistanceField->reload();
+		return;
+	}
+
 	// recreate OpenGL textures
 	for(auto tex : mTextures)
 		tex->initTexture();
 
-	// reupload the texture data
+	// reupload the texture data, from the glyph cache when possible
 	for(auto it = mGlyphMap.cbegin(); it != mGlyphMap.cend(); it++)
 	{
-		FT_Face face = getFaceForChar(it->first);
-		FT_GlyphSlot glyphSlot = face->glyph;
-
-		// load the glyph bitmap through FT
-		FT_Load_Char(face, it->first, FT_LOAD_RENDER);
+		GlyphCache::Entry cached;
+		if (!mGlyphCache->find(it->first, cached) && !rasterizeGlyph(it->first, cached))
+			continue;
 
 		Glyph* glyph = it->second;
-		
+		if (cached.size != glyph->glyphSize || cached.bitmap.empty())
+			continue;
+
 		// upload to texture
 		Renderer::updateTexture(glyph->texture->textureId, Renderer::Texture::ALPHA,
 			glyph->cursor.x(), glyph->cursor.y(),
 			glyph->glyphSize.x(), glyph->glyphSize.y(),
-			glyphSlot->bitmap.buffer);
+			(void*)cached.bitmap.data());
+	}
+}
+
+bool Font::rasterizeGlyph(unsigned int id, GlyphCache::Entry& entry)
+{
+	FT_Face face = getFaceForChar(id);
+	if(!face)
+	{
+		LOG(LogError) << "Could not find appropriate font face for character " << id << " for font " << mPath;
+		return false;
+	}
+
+	FT_GlyphSlot g = face->glyph;
+
+	if(FT_Load_Char(face, id, FT_LOAD_RENDER))
+	{
+		LOG(LogError) << "Could not find glyph for character " << id << " for font " << mPath << ", size " << mSize << "!";
+		return false;
+	}
+
+	entry.size = Vector2i(g->bitmap.width, g->bitmap.rows);
+	entry.advance = Vector2f((float)g->metrics.horiAdvance / 64.0f, (float)g->metrics.vertAdvance / 64.0f);
+	entry.bearing = Vector2f((float)g->metrics.horiBearingX / 64.0f, (float)g->metrics.horiBearingY / 64.0f);
+	entry.bitmap.resize(entry.size.x() * entry.size.y());
+
+	// copy rows one by one, FreeType bitmaps can be padded
+	for (int y = 0; y < entry.size.y(); y++)
+		memcpy(entry.bitmap.data() + y * entry.size.x(), g->bitmap.buffer + y * g->bitmap.pitch, entry.size.x());
+
+	mGlyphCache->add(id, entry);
+	return true;
+}
+
+// Signed distance field of an alpha bitmap (8SSEDT), with a border of 'spread' pixels.
+// Values are stored as 0.5 + distance / (2 * spread), 0.5 being the glyph outline.
+struct DistancePoint
+{
+	int dx, dy;
+	inline int dist() const { return dx * dx + dy * dy; }
+};
+
+static void propagateDistances(std::vector<DistancePoint>& grid, int w, int h)
+{
+	auto compare = [&grid, w, h](DistancePoint& p, int x, int y, int ox, int oy)
+	{
+		x += ox;
+		y += oy;
+
+		if (x < 0 || y < 0 || x >= w || y >= h)
+			return;
+
+		DistancePoint other = grid[y * w + x];
+		other.dx += ox;
+		other.dy += oy;
+
+		if (other.dist() < p.dist())
+			p = other;
+	};
+
+	for (int y = 0; y < h; y++)
+	{
+		for (int x = 0; x < w; x++)
+		{
+			DistancePoint& p = grid[y * w + x];
+			compare(p, x, y, -1, 0);
+			compare(p, x, y, 0, -1);
+			compare(p, x, y, -1, -1);
+			compare(p, x, y, 1, -1);
+		}
+
+		for (int x = w - 1; x >= 0; x--)
+			compare(grid[y * w + x], x, y, 1, 0);
+	}
+
+	for (int y = h - 1; y >= 0; y--)
+	{
+		for (int x = w - 1; x >= 0; x--)
+		{
+			DistancePoint& p = grid[y * w + x];
+			compare(p, x, y, 1, 0);
+			compare(p, x, y, 0, 1);
+			compare(p, x, y, -1, 1);
+			compare(p, x, y, 1, 1);
+		}
+
+		for (int x = 0; x < w; x++)
+			compare(grid[y * w + x], x, y, -1, 0);
+	}
+}
+
+static std::vector<unsigned char> generateDistanceField(const unsigned char* alpha, int w, int h, int spread)
+{
+	const int dw = w + spread * 2;
+	const int dh = h + spread * 2;
+
+	const DistancePoint zeroPoint = { 0, 0 };
+	const DistancePoint farPoint = { 9999, 9999 };
+
+	std::vector<DistancePoint> inside(dw * dh);  // distance to the nearest outside pixel
+	std::vector<DistancePoint> outside(dw * dh); // distance to the nearest inside pixel
+
+	for (int y = 0; y < dh; y++)
+	{
+		for (int x = 0; x < dw; x++)
+		{
+			int sx = x - spread;
+			int sy = y - spread;
+
+			bool in = sx >= 0 && sy >= 0 && sx < w && sy < h && alpha[sy * w + sx] >= 128;
+
+			inside[y * dw + x] = in ? farPoint : zeroPoint;
+			outside[y * dw + x] = in ? zeroPoint : farPoint;
+		}
+	}
+
+	propagateDistances(inside, dw, dh);
+	propagateDistances(outside, dw, dh);
+
+	std::vector<unsigned char> ret(dw * dh);
+
+	for (int i = 0; i < dw * dh; i++)
+	{
+		// the outline lies between pixel centers
+		float dist = inside[i].dist() > 0 ? sqrtf((float)inside[i].dist()) - 0.5f : 0.5f - sqrtf((float)outside[i].dist());
+		float value = 0.5f + dist / (2.0f * spread);
+
+		ret[i] = (unsigned char)(Math::clamp(value, 0.0f, 1.0f) * 255.0f);
+	}
+
+	return ret;
+}
+
+Font::DistanceFieldAtlas::~DistanceFieldAtlas()
+{
+	for (auto tex : mTextures)
+		delete tex;
+
+	mTextures.clear();
+}
+
+const Font::DistanceFieldGlyph* Font::DistanceFieldAtlas::find(unsigned int id)
+{
+	auto it = mGlyphs.find(id);
+	if (it == mGlyphs.cend())
+		return nullptr;
+
+	return &it->second;
+}
+
+const Font::DistanceFieldGlyph* Font::DistanceFieldAtlas::add(unsigned int id, const GlyphCache::Entry* bitmap)
+{
+	DistanceFieldGlyph& glyph = mGlyphs[id];
+	glyph.texture = nullptr;
+	glyph.size = Vector2i::Zero();
+
+	// spaces have no bitmap
+	if (bitmap->size.x() <= 0 || bitmap->size.y() <= 0)
+		return &glyph;
+
+	glyph.size = Vector2i(bitmap->size.x() + FONT_DISTANCE_FIELD_SPREAD * 2, bitmap->size.y() + FONT_DISTANCE_FIELD_SPREAD * 2);
+
+	if (mTextures.size() == 0 || !mTextures.back()->findEmpty(glyph.size, glyph.cursor))
+	{
+		FontTexture* tex = new FontTexture();
+		tex->textureSize = Vector2i(1024, 1024);
+		tex->type = Renderer::Texture::DISTANCE_FIELD;
+		tex->initTexture();
+
+		mTextures.push_back(tex);
+
+		if (!tex->findEmpty(glyph.size, glyph.cursor))
+		{
+			LOG(LogError) << "Distance field glyph " << id << " too big to fit on a new texture";
+			mGlyphs.erase(id);
+			return nullptr;
+		}
+	}
+
+	glyph.texture = mTextures.back();
+	glyph.data = generateDistanceField(bitmap->bitmap.data(), bitmap->size.x(), bitmap->size.y(), FONT_DISTANCE_FIELD_SPREAD);
+
+	Renderer::updateTexture(glyph.texture->textureId, Renderer::Texture::DISTANCE_FIELD, glyph.cursor.x(), glyph.cursor.y(), glyph.size.x(), glyph.size.y(), glyph.data.data());
+
+	return &glyph;
+}
+
+void Font::DistanceFieldAtlas::unload()
+{
+	if (mLoadCount > 0)
+		mLoadCount--;
+
+	// other sizes of the font still draw with these pages
+	if (mLoadCount > 0)
+		return;
+
+	for (auto tex : mTextures)
+		tex->deinitTexture();
+}
+
+void Font::DistanceFieldAtlas::reload()
+{
+	mLoadCount++;
+
+	bool rebuilt = false;
+
+	for (auto tex : mTextures)
+	{
+		if (tex->textureId == 0)
+		{
+			tex->initTexture();
+			rebuilt = true;
+		}
+	}
+
+	if (!rebuilt)
+		return;
+
+	for (auto& glyph : mGlyphs)
+	{
+		DistanceFieldGlyph& g = glyph.second;
+		if (g.texture != nullptr && g.data.size())
+			Renderer::updateTexture(g.texture->textureId, Renderer::Texture::DISTANCE_FIELD, g.cursor.x(), g.cursor.y(), g.size.x(), g.size.y(), g.data.data());
+	}
+}
+
+size_t Font::DistanceFieldAtlas::getMemoryUsage() const
+{
+	size_t memUsage = 0;
+
+	for (auto tex : mTextures)
+		memUsage += (tex->textureId != 0 ? tex->textureSize.x() * tex->textureSize.y() * 4 : 0);
+
+	return memUsage;
+}
+
+Font::Glyph* Font::createDistanceFieldGlyph(unsigned int id, const GlyphCache::Entry* bitmap)
+{
+	const DistanceFieldGlyph* df = mDistanceField->find(id);
+	if (df == nullptr)
+		df = mDistanceField->add(id, bitmap);
+
+	if (df == nullptr)
+		return NULL;
+
+	const float scale = (float)mSize / (float)FONT_DISTANCE_FIELD_SIZE;
+
+	Glyph* pGlyph = new Glyph();
+
+	pGlyph->texture = df->texture;
+	pGlyph->cursor = df->cursor;
+	pGlyph->advance = bitmap->advance * scale;
+	pGlyph->bearing = bitmap->bearing * scale;
+	pGlyph->glyphSize = Vector2i::Zero();
+
+	if (df->texture != nullptr)
+	{
+		// draw 1 more pixel around the glyph, so the antialiased outline isn't cut
+		const float margin = Math::min(1.0f / scale, (float)FONT_DISTANCE_FIELD_SPREAD);
+		const Vector2f textureSize((float)df->texture->textureSize.x(), (float)df->texture->textureSize.y());
+
+		pGlyph->bearing = Vector2f((bitmap->bearing.x() - margin) * scale, (bitmap->bearing.y() + margin) * scale);
+		pGlyph->glyphSize = Vector2i((int)Math::round((bitmap->size.x() + margin * 2) * scale), (int)Math::round((bitmap->size.y() + margin * 2) * scale));
+		pGlyph->texPos = Vector2f((df->cursor.x() + FONT_DISTANCE_FIELD_SPREAD - margin) / textureSize.x(), (df->cursor.y() + FONT_DISTANCE_FIELD_SPREAD - margin) / textureSize.y());
+		pGlyph->texSize = Vector2f((bitmap->size.x() + margin * 2) / textureSize.x(), (bitmap->size.y() + margin * 2) / textureSize.y());
 	}
+
+	return pGlyph;
 }
 
 void Font::renderSingleGlow(TextCache* cache, const Transform4x4f& parentTrans, float x, float y, bool verticesChanged)
@@ -730,7 +1053,7 @@ float Font::getLetterHeight()
 {
 	Glyph* glyph = getGlyph('S');
 	if (glyph != nullptr)
-		return glyph->glyphSize.y();
+		return mDistanceField != nullptr ? glyph->glyphSize.y() - 2 : glyph->glyphSize.y(); // distance field quads have a 1px margin
 
 	return mSize;
 }
@@ -862,7 +1185,193 @@ float Font::getNewlineStartOffset(const std::string& text, const unsigned int& c
 	}
 }
 
-TextCache* Font::buildTextCache(const std::string& _text, Vector2f offset, unsigned int color, float xLen, Alignment alignment, float lineSpacing)
+TextCache* Font::buildTextCache(const std::string& text, Vector2f offset, unsigned int color, float xLen, Alignment alignment, float lineSpacing)
+{
+	bool cacheable = text.size() <= FONT_LAYOUT_CACHE_MAX_TEXT;
+
+	LayoutKey key = { text, offset, xLen, alignment, lineSpacing };
+
+	if (cacheable)
+	{
+		auto it = mLayoutCache.find(key);
+		if (it != mLayoutCache.cend())
+		{
+			mLayoutOrder.splice(mLayoutOrder.begin(), mLayoutOrder, it->second.order);
+
+			TextCache* cache = new TextCache(*it->second.cache);
+			if (it->second.color != color)
+				cache->setColor(color);
+
+			return cache;
+		}
+	}
+
+	TextCache* cache = nullptr;
+
+	if (!EsLocale::isRTL() && text.find_first_of("\n\t\r") == std::string::npos)
+		cache = buildLineTextCache(text, offset, color, xLen, alignment, lineSpacing);
+
+	if (cache == nullptr)
+		cache = buildTextCacheLayout(text, offset, color, xLen, alignment, lineSpacing);
+
+	if (cacheable)
+	{
+		if (mLayoutCache.size() >= FONT_LAYOUT_CACHE_SIZE)
+		{
+			mLayoutCache.erase(mLayoutOrder.back());
+			mLayoutOrder.pop_back();
+		}
+
+		mLayoutOrder.push_front(key);
+
+		LayoutEntry& entry = mLayoutCache[key];
+		entry.cache = std::make_shared<TextCache>(*cache);
+		entry.color = color;
+		entry.order = mLayoutOrder.begin();
+	}
+
+	return cache;
+}
+
+void Font::clearLayoutCache()
+{
+	mLayoutCache.clear();
+	mLayoutOrder.clear();
+	mLastLine = LineLayout();
+}
+
+void Font::addGlyphVertices(std::map<FontTexture*, std::vector<Renderer::Vertex>>& vertMap, Glyph* glyph, float x, float y, unsigned int convertedColor, bool dimmed)
+{
+	std::vector<Renderer::Vertex>& verts = vertMap[glyph->texture];
+	size_t oldVertSize = verts.size();
+	verts.resize(oldVertSize + 6);
+	Renderer::Vertex* vertices = verts.data() + oldVertSize;
+
+	const float glyphStartX = x + glyph->bearing.x();
+
+	vertices[1] = { { glyphStartX                                       , y - glyph->bearing.y()                                          }, { glyph->texPos.x(),                      glyph->texPos.y()                      }, convertedColor };
+	vertices[2] = { { glyphStartX                                       , y - glyph->bearing.y() + (glyph->glyphSize.y())                 }, { glyph->texPos.x(),                      glyph->texPos.y() + glyph->texSize.y() }, convertedColor };
+	vertices[3] = { { glyphStartX + glyph->glyphSize.x()                , y - glyph->bearing.y()                                          }, { glyph->texPos.x() + glyph->texSize.x(), glyph->texPos.y()                      }, convertedColor };
+	vertices[4] = { { glyphStartX + glyph->glyphSize.x()                , y - glyph->bearing.y() + (glyph->glyphSize.y())                 }, { glyph->texPos.x() + glyph->texSize.x(), glyph->texPos.y() + glyph->texSize.y() }, convertedColor };
+
+	// round vertices
+	for (int i = 1; i < 5; ++i)
+	{
+		vertices[i].pos.round();
+		vertices[i].saturation = dimmed ? 0.0f : 1.0f;
+	}
+
+	// make duplicates of first and last vertex so this can be rendered as a triangle strip
+	vertices[0] = vertices[1];
+	vertices[5] = vertices[4];
+}
+
+TextCache* Font::createTextCache(const std::map<FontTexture*, std::vector<Renderer::Vertex>>& vertMap, const Vector2f& size)
+{
+	TextCache* cache = new TextCache();
+	cache->vertexLists.resize(vertMap.size());
+	cache->metrics = { size };
+
+	unsigned int i = 0;
+	for (auto it = vertMap.cbegin(); it != vertMap.cend(); it++)
+	{
+		TextCache::VertexList& vertList = cache->vertexLists.at(i);
+
+		vertList.textureIdPtr = &it->first->textureId;
+		vertList.verts = it->second;
+		i++;
+	}
+
+	return cache;
+}
+
+// Single line texts : the decoded glyphs of the previous line are reused up to the first changed character
+TextCache* Font::buildLineTextCache(const std::string& text, Vector2f offset, unsigned int color, float xLen, Alignment alignment, float lineSpacing)
+{
+	size_t diff = 0;
+	while (diff < text.size() && diff < mLastLine.text.size() && text[diff] == mLastLine.text[diff])
+		diff++;
+
+	size_t common = 0;
+	while (common < mLastLine.charEnds.size() && mLastLine.charEnds[common] <= diff)
+		common++;
+
+	LineLayout line;
+	line.text = text;
+	line.charEnds.assign(mLastLine.charEnds.cbegin(), mLastLine.charEnds.cbegin() + common);
+	line.glyphs.assign(mLastLine.glyphs.cbegin(), mLastLine.glyphs.cbegin() + common);
+	line.flags.assign(mLastLine.flags.cbegin(), mLastLine.flags.cbegin() + common);
+
+	size_t cursor = common ? line.charEnds.back() : 0;
+	unsigned char state = common ? (line.flags.back() & (LINE_IN_PARENTHESIS | LINE_IN_BLOCK)) : 0;
+
+	while (cursor < text.length())
+	{
+		unsigned int character = Utils::String::chars2Unicode(text, cursor); // also advances cursor
+
+		// image substitutes are only handled by the full layout
+		if (substituableChars.find(character) != substituableChars.cend())
+			return nullptr;
+
+		if (character == '(')
+			state |= LINE_IN_PARENTHESIS;
+		else if (character == ')')
+			state &= ~LINE_IN_PARENTHESIS;
+
+		if (character == '[')
+			state |= LINE_IN_BLOCK;
+		else if (character == ']')
+			state &= ~LINE_IN_BLOCK;
+
+		unsigned char flags = state;
+		if (state != 0 || character == ']' || character == ')')
+			flags |= LINE_DIMMED;
+
+		line.charEnds.push_back(cursor);
+		line.glyphs.push_back(character == 0 ? NULL : getGlyph(character));
+		line.flags.push_back(flags);
+	}
+
+	float width = 0;
+	for (auto glyph : line.glyphs)
+		if (glyph != NULL)
+			width += glyph->advance.x();
+
+	float x = offset[0];
+	if (xLen != 0 && alignment == ALIGN_CENTER)
+		x += (xLen - width) / 2.0f;
+	else if (xLen != 0 && alignment == ALIGN_RIGHT)
+		x += xLen - width;
+
+	auto glyph = getGlyph('S');
+	float yTop = glyph ? glyph->bearing.y() : 35;
+	float yBot = getHeight(lineSpacing);
+	float y = offset[1] + (yBot + yTop) / 2.0f;
+
+	const unsigned int convertedColor = Renderer::convertColor(color);
+
+	std::map<FontTexture*, std::vector<Renderer::Vertex>> vertMap;
+
+	for (size_t i = 0; i < line.glyphs.size(); i++)
+	{
+		Glyph* glyph = line.glyphs[i];
+		if (glyph == NULL)
+			continue;
+
+		if (glyph->texture != NULL)
+			addGlyphVertices(vertMap, glyph, x, y, convertedColor, (line.flags[i] & LINE_DIMMED) != 0);
+
+		x += glyph->advance.x();
+	}
+
+	mLastLine = std::move(line);
+
+	clearFaceCache();
+
+	return createTextCache(vertMap, Vector2f(width, yBot));
+}
+
+TextCache* Font::buildTextCacheLayout(const std::string& _text, Vector2f offset, unsigned int color, float xLen, Alignment alignment, float lineSpacing)
 {
 	float x = offset[0] + (xLen != 0 ? getNewlineStartOffset(_text, 0, xLen, alignment) : 0);
 	
@@ -1021,55 +1530,17 @@ TextCache* Font::buildTextCache(const std::string& _text, Vector2f offset, unsig
 		if(glyph == NULL)
 			continue;
 
-		std::vector<Renderer::Vertex>& verts = vertMap[glyph->texture];
-		size_t oldVertSize = verts.size();
-		verts.resize(oldVertSize + 6);
-		Renderer::Vertex* vertices = verts.data() + oldVertSize;
-
-		const float        glyphStartX    = x + glyph->bearing.x();
-		const unsigned int convertedColor = Renderer::convertColor(color);
-
-		vertices[1] = { { glyphStartX                                       , y - glyph->bearing.y()                                          }, { glyph->texPos.x(),                      glyph->texPos.y()                      }, convertedColor };
-		vertices[2] = { { glyphStartX                                       , y - glyph->bearing.y() + (glyph->glyphSize.y())                 }, { glyph->texPos.x(),                      glyph->texPos.y() + glyph->texSize.y() }, convertedColor };
-		vertices[3] = { { glyphStartX + glyph->glyphSize.x()                , y - glyph->bearing.y()                                          }, { glyph->texPos.x() + glyph->texSize.x(), glyph->texPos.y()                      }, convertedColor };
-		vertices[4] = { { glyphStartX + glyph->glyphSize.x()                , y - glyph->bearing.y() + (glyph->glyphSize.y())                 }, { glyph->texPos.x() + glyph->texSize.x(), glyph->texPos.y() + glyph->texSize.y() }, convertedColor };
-
-		// round vertices
-		for (int i = 1; i < 5; ++i)
-		{
-			vertices[i].pos.round();
-
-			if (inParenthesis || inBlock || character == ']' || character == ')')
-				vertices[i].saturation = 0.0f;
-			else
-				vertices[i].saturation = 1.0f;
-		}
-
-		// make duplicates of first and last vertex so this can be rendered as a triangle strip
-		vertices[0] = vertices[1];
-		vertices[5] = vertices[4];
+		// distance field glyphs without bitmap (spaces) have no texture
+		if (glyph->texture != NULL)
+			addGlyphVertices(vertMap, glyph, x, y, Renderer::convertColor(color), inParenthesis || inBlock || character == ']' || character == ')');
 
 		// advance
 		x += glyph->advance.x();
 	}
 
-	//TextCache::CacheMetrics metrics = { sizeText(text, lineSpacing) };
-
-	TextCache* cache = new TextCache();
-	cache->vertexLists.resize(vertMap.size());
-	cache->metrics = { sizeText(text, lineSpacing) };
+	TextCache* cache = createTextCache(vertMap, sizeText(text, lineSpacing));
 	cache->imageSubstitutes = imageSubstitutes;
 
-	unsigned int i = 0;
-	for(auto it = vertMap.cbegin(); it != vertMap.cend(); it++)
-	{
-		TextCache::VertexList& vertList = cache->vertexLists.at(i);
-
-		vertList.textureIdPtr = &it->first->textureId;
-		vertList.verts = it->second;
-		i++;
-	}
-
 	clearFaceCache();
 
 	return cache;
@@ -1204,4 +1675,9 @@ void Font::OnThemeChanged()
 			}
 		}
 	}
+
+	// substitutes may have changed
+	for (auto font : sFontMap)
+		if (!font.second.expired())
+			font.second.lock()->clearLayoutCache();
 }
@@ -6,10 +6,14 @@
 #include "math/Vector2i.h"
 #include "renderers/Renderer.h"
 #include "resources/ResourceManager.h"
+#include "resources/GlyphCache.h"
 #include "ThemeData.h"
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include <vector>
+#include <list>
+#include <map>
+#include <tuple>
 #include <unordered_map>
 
 class TextCache;
@@ -20,6 +24,22 @@ class TextureResource;
 #define FONT_SIZE_MEDIUM ((unsigned int)(0.045f * Math::min((int)Renderer::getScreenHeight(), (int)Renderer::getScreenWidth())))
 #define FONT_SIZE_LARGE ((unsigned int)(0.085f * Math::min((int)Renderer::getScreenHeight(), (int)Renderer::getScreenWidth())))
 
+// Distance field glyphs are rasterized once at this size, and scaled to every font size
+#define FONT_DISTANCE_FIELD_SIZE 64
+#define FONT_DISTANCE_FIELD_SPREAD 8
+
+// Glyphs beyond ASCII used in the previous runs (accents, CJK...) are created with the font, up to this count
+#define FONT_PREWARM_GLYPHS 256
+
+// Layouts of short texts are kept by each font, and copied when the same text is built again
+#define FONT_LAYOUT_CACHE_SIZE 256
+#define FONT_LAYOUT_CACHE_MAX_TEXT 256
+
+// Flags of the characters of a single line layout
+#define LINE_IN_PARENTHESIS 1
+#define LINE_IN_BLOCK 2
+#define LINE_DIMMED 4
+
 #ifdef WIN32
 #define FONT_PATH_LIGHT ":/opensans_hebrew_condensed_light.ttf"
 #define FONT_PATH_REGULAR ":/opensans_hebrew_condensed_regular.ttf"
@@ -92,6 +112,7 @@ private:
 	public:
 		unsigned int textureId;
 		Vector2i textureSize;
+		Renderer::Texture::Type type;
 
 		Vector2i writePos;
 		int rowHeight;
@@ -118,6 +139,39 @@ private:
 
 	std::vector<FontTexture*> mTextures;
 
+	struct DistanceFieldGlyph
+	{
+		FontTexture* texture;
+		Vector2i cursor;
+		Vector2i size; // in texels, including the spread on each side
+		std::vector<unsigned char> data;
+	};
+
+	// Distance field pages of a font file, shared by all the sizes of this font
+	class DistanceFieldAtlas
+	{
+	public:
+		DistanceFieldAtlas() : mLoadCount(0) { }
+		~DistanceFieldAtlas();
+
+		const DistanceFieldGlyph* find(unsigned int id);
+		const DistanceFieldGlyph* add(unsigned int id, const GlyphCache::Entry* bitmap);
+
+		// Called by each font when it's loaded or unloaded : the pages are released when the last loaded font unloads
+		void unload();
+		void reload();
+
+		size_t getMemoryUsage() const;
+
+	private:
+		int mLoadCount;
+		std::vector<FontTexture*> mTextures;
+		std::unordered_map<unsigned int, DistanceFieldGlyph> mGlyphs;
+	};
+
+	static std::map<std::string, std::weak_ptr<DistanceFieldAtlas>> sDistanceFieldAtlases;
+	std::shared_ptr<DistanceFieldAtlas> mDistanceField;
+
 	void getTextureForNewGlyph(const Vector2i& glyphSize, FontTexture*& tex_out, Vector2i& cursor_out);
 
 	std::map< unsigned int, std::unique_ptr<FontFace> > mFaceCache;
@@ -142,15 +196,62 @@ private:
 	std::unordered_map<unsigned int, Glyph*> mGlyphMap;
 
 	Glyph* getGlyph(unsigned int id);
+	Glyph* createDistanceFieldGlyph(unsigned int id, const GlyphCache::Entry* bitmap);
+	bool rasterizeGlyph(unsigned int id, GlyphCache::Entry& entry);
+
+	std::shared_ptr<GlyphCache> mGlyphCache;
 
 	int mMaxGlyphHeight;
 	
 	int mSize;
+	int mFaceSize; // size of the FreeType faces, FONT_DISTANCE_FIELD_SIZE in distance field mode
 	const std::string mPath;
 	bool mLoaded;
 
 	float getNewlineStartOffset(const std::string& text, const unsigned int& charStart, const float& xLen, const Alignment& alignment);
 
+	TextCache* buildTextCacheLayout(const std::string& text, Vector2f offset, unsigned int color, float xLen, Alignment alignment, float lineSpacing);
+	TextCache* buildLineTextCache(const std::string& text, Vector2f offset, unsigned int color, float xLen, Alignment alignment, float lineSpacing);
+	TextCache* createTextCache(const std::map<FontTexture*, std::vector<Renderer::Vertex>>& vertMap, const Vector2f& size);
+	void addGlyphVertices(std::map<FontTexture*, std::vector<Renderer::Vertex>>& vertMap, Glyph* glyph, float x, float y, unsigned int convertedColor, bool dimmed);
+
+	struct LayoutKey
+	{
+		std::string text;
+		Vector2f offset;
+		float xLen;
+		Alignment alignment;
+		float lineSpacing;
+
+		bool operator<(const LayoutKey& other) const
+		{
+			return std::tie(text, offset.x(), offset.y(), xLen, alignment, lineSpacing) < std::tie(other.text, other.offset.x(), other.offset.y(), other.xLen, other.alignment, other.lineSpacing);
+		}
+	};
+
+	struct LayoutEntry
+	{
+		std::shared_ptr<TextCache> cache;
+		unsigned int color;
+		std::list<LayoutKey>::iterator order;
+	};
+
+	std::map<LayoutKey, LayoutEntry> mLayoutCache;
+	std::list<LayoutKey> mLayoutOrder; // most recently used first
+
+	void clearLayoutCache();
+
+	// Decoded glyphs of the last single line text
+	struct LineLayout
+	{
+		std::string text;
+		std::vector<size_t> charEnds; // byte offset after each character
+		std::vector<Glyph*> glyphs;
+		std::vector<unsigned char> flags;
+	};
+
+	LineLayout mLastLine;
+
 	friend TextCache;
 };
 
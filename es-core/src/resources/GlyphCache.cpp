@@ -0,0 +1,244 @@
+#include "resources/GlyphCache.h"
+
+#include "resources/ResourceManager.h"
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+#include "Paths.h"
+#include "Log.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+#define GLYPH_CACHE_MAGIC 0x43475345 // "ESGC"
+#define GLYPH_CACHE_VERSION 2
+#define GLYPH_CACHE_MAX_GLYPHS 2048
+
+std::map<std::pair<std::string, int>, std::shared_ptr<GlyphCache>> GlyphCache::sCaches;
+std::mutex GlyphCache::sCachesLock;
+
+static std::string getGlyphCachePath()
+{
+	return Utils::FileSystem::getGenericPath(Paths::getUserEmulationStationPath() + "/tmp/glyphs");
+}
+
+static FILE* openFile(const std::string& path, const char* mode)
+{
+#if defined(_WIN32)
+	return _wfopen(Utils::String::convertToWideString(path).c_str(), Utils::String::convertToWideString(mode).c_str());
+#else
+	return fopen(path.c_str(), mode);
+#endif
+}
+
+static std::string getFontStamp(const std::string& fontPath)
+{
+	std::string realPath = ResourceManager::getInstance()->getResourcePath(fontPath);
+
+	return realPath + "|" +
+		std::to_string(Utils::FileSystem::getFileSize(realPath)) + "|" +
+		std::to_string((long long)Utils::FileSystem::getFileModificationDate(realPath).getTime());
+}
+
+std::shared_ptr<GlyphCache> GlyphCache::get(const std::string& fontPath, const std::vector<std::string>& fallbackFonts, int size)
+{
+	std::unique_lock<std::mutex> lock(sCachesLock);
+
+	std::pair<std::string, int> def(fontPath, size);
+
+	auto it = sCaches.find(def);
+	if (it != sCaches.cend())
+		return it->second;
+
+	// The font file stamps are part of the key : an updated theme or fallback font invalidates its glyphs
+	std::string key = getFontStamp(fontPath) + "|" + std::to_string(size);
+	for (auto& fallbackFont : fallbackFonts)
+		key += "|" + getFontStamp(fallbackFont);
+
+	char hash[32];
+	snprintf(hash, sizeof(hash), "%016llx", (unsigned long long) std::hash<std::string>()(key));
+
+	std::shared_ptr<GlyphCache> cache = std::shared_ptr<GlyphCache>(new GlyphCache(key, getGlyphCachePath() + "/" + hash + ".bin"));
+	sCaches[def] = cache;
+	return cache;
+}
+
+void GlyphCache::saveAll()
+{
+	std::unique_lock<std::mutex> lock(sCachesLock);
+
+	for (auto cache : sCaches)
+		cache.second->save();
+}
+
+GlyphCache::GlyphCache(const std::string& key, const std::string& filePath) : mKey(key), mFilePath(filePath), mDirty(false)
+{
+	load();
+}
+
+bool GlyphCache::find(unsigned int id, Entry& entry)
+{
+	std::unique_lock<std::mutex> lock(mLock);
+
+	auto it = mGlyphs.find(id);
+	if (it == mGlyphs.cend())
+		return false;
+
+	mLru.splice(mLru.begin(), mLru, it->second.lru);
+	entry = it->second.entry;
+	return true;
+}
+
+void GlyphCache::add(unsigned int id, const Entry& entry)
+{
+	std::unique_lock<std::mutex> lock(mLock);
+
+	mDirty = true;
+	insert(id, entry);
+}
+
+std::vector<unsigned int> GlyphCache::getCodepoints(unsigned int minId, size_t maxCount)
+{
+	std::unique_lock<std::mutex> lock(mLock);
+
+	std::vector<unsigned int> ret;
+	for (auto id : mLru)
+	{
+		if (ret.size() >= maxCount)
+			break;
+
+		if (id >= minId)
+			ret.push_back(id);
+	}
+
+	return ret;
+}
+
+// mLock must be locked
+void GlyphCache::insert(unsigned int id, const Entry& entry)
+{
+	auto it = mGlyphs.find(id);
+	if (it != mGlyphs.cend())
+	{
+		it->second.entry = entry;
+		mLru.splice(mLru.begin(), mLru, it->second.lru);
+		return;
+	}
+
+	// Drop the least recently used glyph
+	if (mGlyphs.size() >= GLYPH_CACHE_MAX_GLYPHS)
+	{
+		mGlyphs.erase(mLru.back());
+		mLru.pop_back();
+	}
+
+	mLru.push_front(id);
+
+	Item& item = mGlyphs[id];
+	item.entry = entry;
+	item.lru = mLru.begin();
+}
+
+void GlyphCache::load()
+{
+	FILE* file = openFile(mFilePath, "rb");
+	if (file == nullptr)
+		return;
+
+	bool valid = false;
+
+	unsigned int header[3];
+	if (fread(header, sizeof(unsigned int), 3, file) == 3 && header[0] == GLYPH_CACHE_MAGIC && header[1] == GLYPH_CACHE_VERSION && header[2] == mKey.size())
+	{
+		std::string key(header[2], '\0');
+		unsigned int count = 0;
+
+		if (fread(&key[0], 1, key.size(), file) == key.size() && key == mKey && fread(&count, sizeof(unsigned int), 1, file) == 1 && count <= GLYPH_CACHE_MAX_GLYPHS)
+		{
+			valid = true;
+
+			for (unsigned int i = 0; i < count && valid; i++)
+			{
+				unsigned int id;
+				int size[2];
+				float metrics[4];
+
+				if (fread(&id, sizeof(unsigned int), 1, file) != 1 || fread(size, sizeof(int), 2, file) != 2 || fread(metrics, sizeof(float), 4, file) != 4 ||
+					size[0] < 0 || size[1] < 0 || size[0] > 2048 || size[1] > 2048)
+				{
+					valid = false;
+					break;
+				}
+
+				Entry entry;
+				entry.size = Vector2i(size[0], size[1]);
+				entry.advance = Vector2f(metrics[0], metrics[1]);
+				entry.bearing = Vector2f(metrics[2], metrics[3]);
+				entry.bitmap.resize(size[0] * size[1]);
+
+				if (entry.bitmap.size() && fread(entry.bitmap.data(), 1, entry.bitmap.size(), file) != entry.bitmap.size())
+				{
+					valid = false;
+					break;
+				}
+
+				insert(id, entry);
+			}
+		}
+	}
+
+	fclose(file);
+
+	if (!valid)
+	{
+		LOG(LogWarning) << "GlyphCache : ignoring invalid cache file " << mFilePath;
+		mGlyphs.clear();
+		mLru.clear();
+		mDirty = true;
+	}
+}
+
+void GlyphCache::save()
+{
+	std::unique_lock<std::mutex> lock(mLock);
+
+	if (!mDirty)
+		return;
+
+	std::string path = getGlyphCachePath();
+	if (!Utils::FileSystem::exists(path))
+		Utils::FileSystem::createDirectory(path);
+
+	FILE* file = openFile(mFilePath, "wb");
+	if (file == nullptr)
+	{
+		LOG(LogWarning) << "GlyphCache : unable to write " << mFilePath;
+		return;
+	}
+
+	unsigned int count = (unsigned int) mGlyphs.size();
+	unsigned int header[3] = { GLYPH_CACHE_MAGIC, GLYPH_CACHE_VERSION, (unsigned int) mKey.size() };
+
+	fwrite(header, sizeof(unsigned int), 3, file);
+	fwrite(mKey.data(), 1, mKey.size(), file);
+	fwrite(&count, sizeof(unsigned int), 1, file);
+
+	// Least recently used first : they are loaded in the same order
+	for (auto it = mLru.crbegin(); it != mLru.crend(); ++it)
+	{
+		unsigned int id = *it;
+		const Entry& entry = mGlyphs[id].entry;
+
+		int size[2] = { entry.size.x(), entry.size.y() };
+		float metrics[4] = { entry.advance.x(), entry.advance.y(), entry.bearing.x(), entry.bearing.y() };
+
+		fwrite(&id, sizeof(unsigned int), 1, file);
+		fwrite(size, sizeof(int), 2, file);
+		fwrite(metrics, sizeof(float), 4, file);
+
+		if (entry.bitmap.size())
+			fwrite(entry.bitmap.data(), 1, entry.bitmap.size(), file);
+	}
+
+	fclose(file);
+	mDirty = false;
+}
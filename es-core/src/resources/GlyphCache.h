@@ -0,0 +1,65 @@
+#pragma once
+#ifndef ES_CORE_RESOURCES_GLYPH_CACHE_H
+#define ES_CORE_RESOURCES_GLYPH_CACHE_H
+
+#include "math/Vector2f.h"
+#include "math/Vector2i.h"
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Rasterized glyphs (alpha bitmap & metrics) for a font file at a given pixel size.
+// A cache is shared by all the Font instances using the same file & size, and is persisted on disk
+// so glyphs don't need to be rasterized by FreeType again on the next boot or after a context loss.
+// The fallback fonts are part of the key, as glyphs missing from the font come from them.
+// Only the most recently used glyphs are kept.
+class GlyphCache
+{
+public:
+	struct Entry
+	{
+		Vector2i size;
+		Vector2f advance;
+		Vector2f bearing;
+		std::vector<unsigned char> bitmap;
+	};
+
+	static std::shared_ptr<GlyphCache> get(const std::string& fontPath, const std::vector<std::string>& fallbackFonts, int size);
+	static void saveAll();
+
+	bool find(unsigned int id, Entry& entry);
+	void add(unsigned int id, const Entry& entry);
+
+	// Glyphs from minId, most recently used first, including the ones from previous runs
+	std::vector<unsigned int> getCodepoints(unsigned int minId, size_t maxCount);
+
+private:
+	GlyphCache(const std::string& key, const std::string& filePath);
+
+	void load();
+	void save();
+	void insert(unsigned int id, const Entry& entry);
+
+	std::string mKey;
+	std::string mFilePath;
+	bool mDirty;
+
+	struct Item
+	{
+		Entry entry;
+		std::list<unsigned int>::iterator lru;
+	};
+
+	std::mutex mLock;
+	std::unordered_map<unsigned int, Item> mGlyphs;
+	std::list<unsigned int> mLru; // most recently used first
+
+	static std::map<std::pair<std::string, int>, std::shared_ptr<GlyphCache>> sCaches;
+	static std::mutex sCachesLock;
+};
+
+#endif // ES_CORE_RESOURCES_GLYPH_CACHE_H
@@ -0,0 +1,216 @@
+#include "resources/TextureAtlas.h"
+
+#include "math/Misc.h"
+#include "renderers/Renderer.h"
+#include "Settings.h"
+#include "Log.h"
+#include <string.h>
+
+std::vector<TextureAtlas::Page*> TextureAtlas::sPages;
+std::mutex TextureAtlas::sMutex;
+
+bool TextureAtlas::Page::findEmpty(const Vector2i& size, Vector2i& cursor_out)
+{
+	// Reuse a released slot first
+	for (auto it = freeRects.begin(); it != freeRects.end(); ++it)
+	{
+		if (it->second.x() >= size.x() && it->second.y() >= size.y())
+		{
+			Vector2i pos = it->first;
+			Vector2i rect = it->second;
+
+			cursor_out = pos;
+			freeRects.erase(it);
+
+			// Give back the unused parts : the right side at the image height, and the whole width below it
+			if (rect.x() > size.x())
+				freeRects.push_back(std::pair<Vector2i, Vector2i>(Vector2i(pos.x() + size.x(), pos.y()), Vector2i(rect.x() - size.x(), size.y())));
+
+			if (rect.y() > size.y())
+				freeRects.push_back(std::pair<Vector2i, Vector2i>(Vector2i(pos.x(), pos.y() + size.y()), Vector2i(rect.x(), rect.y() - size.y())));
+
+			return true;
+		}
+	}
+
+	if (writePos.x() + size.x() > TEXTURE_ATLAS_PAGE_SIZE && writePos.y() + rowHeight + size.y() <= TEXTURE_ATLAS_PAGE_SIZE)
+	{
+		// row full, but it should fit on the next row
+		writePos = Vector2i(0, writePos.y() + rowHeight);
+		rowHeight = 0;
+	}
+
+	if (writePos.x() + size.x() > TEXTURE_ATLAS_PAGE_SIZE || writePos.y() + size.y() > TEXTURE_ATLAS_PAGE_SIZE)
+		return false;
+
+	cursor_out = writePos;
+	writePos[0] += size.x();
+
+	if (size.y() > rowHeight)
+		rowHeight = size.y();
+
+	return true;
+}
+
+bool TextureAtlas::isEligible(const Vector2i& size, bool tile)
+{
+	if (tile || size.x() <= 0 || size.y() <= 0)
+		return false;
+
+	if (size.x() > TEXTURE_ATLAS_MAX_IMAGE_SIZE || size.y() > TEXTURE_ATLAS_MAX_IMAGE_SIZE)
+		return false;
+
+	return Settings::getInstance()->getBool("TextureAtlas");
+}
+
+bool TextureAtlas::add(const unsigned char* dataRGBA, const Vector2i& size, bool linear, Region& region_out)
+{
+	if (dataRGBA == nullptr)
+		return false;
+
+	std::unique_lock<std::mutex> lock(sMutex);
+
+	// Keep a 1px border around the image
+	Vector2i slotSize(size.x() + 2, size.y() + 2);
+
+	Page* page = nullptr;
+	int pageIndex = -1;
+	Vector2i cursor;
+
+	for (int i = 0; i < (int)sPages.size(); i++)
+	{
+		if (sPages[i] != nullptr && sPages[i]->linear == linear && sPages[i]->findEmpty(slotSize, cursor))
+		{
+			page = sPages[i];
+			pageIndex = i;
+			break;
+		}
+	}
+
+	if (page == nullptr)
+	{
+		page = new Page(linear);
+		page->textureId = Renderer::createTexture(Renderer::Texture::RGBA, linear, false, TEXTURE_ATLAS_PAGE_SIZE, TEXTURE_ATLAS_PAGE_SIZE, nullptr);
+		if (page->textureId == 0)
+		{
+			LOG(LogError) << "TextureAtlas::add failed to create page texture";
+			delete page;
+			return false;
+		}
+
+		// Reuse an empty page slot if any
+		for (int i = 0; i < (int)sPages.size(); i++)
+		{
+			if (sPages[i] == nullptr)
+			{
+				sPages[i] = page;
+				pageIndex = i;
+				break;
+			}
+		}
+
+		if (pageIndex < 0)
+		{
+			sPages.push_back(page);
+			pageIndex = (int)sPages.size() - 1;
+		}
+
+		page->findEmpty(slotSize, cursor);
+	}
+
+	// Extrude the image edges into the border
+	const int w = size.x();
+	const int h = size.y();
+	const int sw = slotSize.x();
+
+	unsigned char* slot = new unsigned char[slotSize.x() * slotSize.y() * 4];
+
+	for (int y = 0; y < slotSize.y(); y++)
+	{
+		int srcY = Math::clamp(y - 1, 0, h - 1);
+		unsigned char* dst = slot + y * sw * 4;
+		const unsigned char* src = dataRGBA + srcY * w * 4;
+
+		memcpy(dst, src, 4);
+		memcpy(dst + 4, src, w * 4);
+		memcpy(dst + (sw - 1) * 4, src + (w - 1) * 4, 4);
+	}
+
+	Renderer::updateTexture(page->textureId, Renderer::Texture::RGBA, cursor.x(), cursor.y(), slotSize.x(), slotSize.y(), slot);
+	delete[] slot;
+
+	page->count++;
+
+	region_out.page = pageIndex;
+	region_out.pos = cursor;
+	region_out.size = slotSize;
+	region_out.uv = Vector4f(
+		(float)(cursor.x() + 1) / (float)TEXTURE_ATLAS_PAGE_SIZE,
+		(float)(cursor.y() + 1) / (float)TEXTURE_ATLAS_PAGE_SIZE,
+		(float)w / (float)TEXTURE_ATLAS_PAGE_SIZE,
+		(float)h / (float)TEXTURE_ATLAS_PAGE_SIZE);
+
+	return true;
+}
+
+void TextureAtlas::remove(Region& region)
+{
+	if (!region.valid())
+		return;
+
+	std::unique_lock<std::mutex> lock(sMutex);
+
+	if (region.page < (int)sPages.size() && sPages[region.page] != nullptr)
+	{
+		Page* page = sPages[region.page];
+		page->count--;
+
+		if (page->count <= 0)
+		{
+			// Nothing left on this page : release its VRAM.
+			// This also happens for all pages when the renderer is deinitialized, as every texture is unloaded
+			Renderer::destroyTexture(page->textureId);
+			delete page;
+			sPages[region.page] = nullptr;
+		}
+		else
+			page->freeRects.push_back(std::pair<Vector2i, Vector2i>(region.pos, region.size));
+	}
+
+	region = Region();
+}
+
+bool TextureAtlas::bind(const Region& region)
+{
+	std::unique_lock<std::mutex> lock(sMutex);
+
+	if (!region.valid() || region.page >= (int)sPages.size() || sPages[region.page] == nullptr)
+		return false;
+
+	Renderer::bindTexture(sPages[region.page]->textureId);
+	return true;
+}
+
+size_t TextureAtlas::getMemoryUsage()
+{
+	std::unique_lock<std::mutex> lock(sMutex);
+
+	size_t total = 0;
+	for (auto page : sPages)
+		if (page != nullptr)
+			total += TEXTURE_ATLAS_PAGE_SIZE * TEXTURE_ATLAS_PAGE_SIZE * 4;
+
+	return total;
+}
+
+int TextureAtlas::getPageCount()
+{
+	std::unique_lock<std::mutex> lock(sMutex);
+
+	int count = 0;
+	for (auto page : sPages)
+		if (page != nullptr)
+			count++;
+
+	return count;
+}
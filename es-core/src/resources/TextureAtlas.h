@@ -0,0 +1,63 @@
+#pragma once
+#ifndef ES_CORE_RESOURCES_TEXTURE_ATLAS_H
+#define ES_CORE_RESOURCES_TEXTURE_ATLAS_H
+
+#include "math/Vector2i.h"
+#include "math/Vector4f.h"
+#include <mutex>
+#include <vector>
+
+#define TEXTURE_ATLAS_PAGE_SIZE 1024
+#define TEXTURE_ATLAS_MAX_IMAGE_SIZE 128
+
+// Packs small images (help icons, flags, favorite/cheevos icons...) into shared texture pages,
+// so consecutive draws of different small images don't need a texture bind each.
+// Images are added when they are first uploaded, and removed when their VRAM is released.
+class TextureAtlas
+{
+public:
+	struct Region
+	{
+		Region() : page(-1) { }
+
+		inline bool valid() const { return page >= 0; }
+
+		int		 page;
+		Vector2i pos;  // in texels, including the 1px border
+		Vector2i size; // in texels, including the 1px border
+		Vector4f uv;   // x, y = top left & z, w = size, normalized to the page
+	};
+
+	static bool isEligible(const Vector2i& size, bool tile);
+
+	// Copies the image into a page (with a 1px extruded border to avoid bleeding with linear filtering).
+	// Linear & nearest filtered images never share a page.
+	static bool add(const unsigned char* dataRGBA, const Vector2i& size, bool linear, Region& region_out);
+	static void remove(Region& region);
+	static bool bind(const Region& region);
+
+	static size_t getMemoryUsage();
+	static int getPageCount();
+
+private:
+	struct Page
+	{
+		Page(bool linear) : textureId(0), linear(linear), writePos(Vector2i::Zero()), rowHeight(0), count(0) { }
+
+		bool findEmpty(const Vector2i& size, Vector2i& cursor_out);
+
+		unsigned int textureId;
+		bool linear;
+
+		Vector2i writePos;
+		int rowHeight;
+		int count;
+
+		std::vector<std::pair<Vector2i, Vector2i>> freeRects; // pos, size
+	};
+
+	static std::vector<Page*> sPages;
+	static std::mutex		  sMutex;
+};
+
+#endif // ES_CORE_RESOURCES_TEXTURE_ATLAS_H
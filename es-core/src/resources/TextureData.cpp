@@ -30,6 +30,7 @@ TextureData::TextureData(bool tile, bool linear) :
 {
 	mIsExternalDataRGBA = false;
 	mRequired = false;
+	mAtlasAllowed = false;
 }
 
 TextureData::~TextureData()
@@ -50,7 +51,7 @@ bool TextureData::initSVGFromMemory(const unsigned char* fileData, size_t length
 {
 	// If already initialised then don't read again
 	std::unique_lock<std::mutex> lock(mMutex);
-	if (mDataRGBA || (mTextureID != 0))
+	if (mDataRGBA || (mTextureID != 0) || mAtlasRegion.valid())
 		return true;
 
 	// nsvgParse excepts a modifiable, null-terminated string
@@ -238,7 +239,7 @@ bool TextureData::updateFromExternalRGBA(unsigned char* dataRGBA, size_t width,
 	mPhysicalSize = Vector2f(width, height);
 
 	if (mTextureID != 0)
-		Renderer::updateTexture(mTextureID, Renderer::Texture::RGBA, 0, 0, width, height, mDataRGBA);
+		Renderer::streamTexture(mTextureID, Renderer::Texture::RGBA, width, height, mDataRGBA);
 
 	return true;
 }
@@ -470,7 +471,7 @@ bool TextureData::load()
 bool TextureData::isLoaded()
 {
 	std::unique_lock<std::mutex> lock(mMutex);
-	if (mDataRGBA || (mTextureID != 0))
+	if (mDataRGBA || (mTextureID != 0) || mAtlasRegion.valid())
 		return true;
 
 	return false;
@@ -483,6 +484,8 @@ bool TextureData::uploadAndBind()
 
 	if (mTextureID != 0)
 		Renderer::bindTexture(mTextureID);
+	else if (mAtlasRegion.valid())
+		return TextureAtlas::bind(mAtlasRegion);
 	else
 	{
 		// Make sure we're ready to upload
@@ -492,6 +495,15 @@ bool TextureData::uploadAndBind()
 			return false;
 		}
 
+		// Small images go to the atlas if the owner accepts remapped texture coordinates
+		if (mAtlasAllowed && !mIsExternalDataRGBA && TextureAtlas::isEligible(mSize, mTile) && TextureAtlas::add(mDataRGBA, mSize, mLinear, mAtlasRegion))
+		{
+			delete[] mDataRGBA;
+			mDataRGBA = nullptr;
+
+			return TextureAtlas::bind(mAtlasRegion);
+		}
+
 		// Upload texture
 		mTextureID = Renderer::createTexture(Renderer::Texture::RGBA, mLinear, mTile, mSize.x(), mSize.y(), mDataRGBA);
 		if (mTextureID == 0)
@@ -514,6 +526,17 @@ void TextureData::releaseVRAM()
 		Renderer::destroyTexture(mTextureID);
 		mTextureID = 0;
 	}
+
+	TextureAtlas::remove(mAtlasRegion);
+}
+
+Vector4f TextureData::getTextureRect()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (mAtlasRegion.valid())
+		return mAtlasRegion.uv;
+
+	return Vector4f(0.0f, 0.0f, 1.0f, 1.0f);
 }
 
 void TextureData::releaseRAM()
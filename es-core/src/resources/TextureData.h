@@ -7,6 +7,7 @@
 #include <vector>
 #include "ImageIO.h"
 #include "TextureDataManager.h"
+#include "TextureAtlas.h"
 
 class TextureResource;
 
@@ -58,12 +59,12 @@ public:
 			return mDataRGBA != nullptr ? mSize.x() * mSize.y() * 4 : 0;
 
 		if (type == MemoryUsageType::VRAM)
-			return mTextureID != 0 ? mSize.x() * mSize.y() * 4 : 0;
+			return mTextureID != 0 || mAtlasRegion.valid() ? mSize.x() * mSize.y() * 4 : 0;
 
 		if (type == MemoryUsageType::Estimated)
 			return mSize.x() * mSize.y() * 4;
 
-		return mTextureID != 0 || mDataRGBA != nullptr ? mSize.x() * mSize.y() * 4 : 0;
+		return mTextureID != 0 || mAtlasRegion.valid() || mDataRGBA != nullptr ? mSize.x() * mSize.y() * 4 : 0;
 	}
 
 	const 	Vector2i& getSize() const { return mSize; }
@@ -93,6 +94,13 @@ public:
 	inline bool isScalable() { return mScalable; }
 	void setScalable(bool value) { mScalable = value; };
 
+	// Small images can be packed into a shared atlas page instead of their own texture
+	inline bool isAtlasAllowed() { return mAtlasAllowed; }
+	void setAtlasAllowed(bool value) { mAtlasAllowed = value; };
+
+	// Returns the area used by the texture ( x, y, w, h ) in normalized texture coordinates
+	Vector4f getTextureRect();
+
 private:
 	bool			mRequired;
 
@@ -114,6 +122,9 @@ private:
 	Vector2f		mScalableMinimumSize;
 
 	bool			mIsExternalDataRGBA;
+
+	bool					mAtlasAllowed;
+	TextureAtlas::Region	mAtlasRegion;
 };
 
 #endif // ES_CORE_RESOURCES_TEXTURE_DATA_H
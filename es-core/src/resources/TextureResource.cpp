@@ -12,7 +12,7 @@ TextureDataManager		TextureResource::sTextureDataManager;
 std::map< TextureResource::TextureKeyType, std::weak_ptr<TextureResource> > TextureResource::sTextureMap;
 std::set<TextureResource*> 	TextureResource::sNonDynamicTextureResources;
 
-TextureResource::TextureResource(const std::string& path, bool tile, bool linear, bool dynamic, bool allowAsync, const MaxSizeInfo* maxSize) : mTextureData(nullptr), mForceLoad(false)
+TextureResource::TextureResource(const std::string& path, bool tile, bool linear, bool dynamic, bool allowAsync, const MaxSizeInfo* maxSize, bool allowAtlas) : mTextureData(nullptr), mForceLoad(false)
 {
 	// Create a texture data object for this texture
 	if (!path.empty())
@@ -25,6 +25,8 @@ TextureResource::TextureResource(const std::string& path, bool tile, bool linear
 			if (maxSize != nullptr)
 				data->setMaxSize(*maxSize);
 
+			data->setAtlasAllowed(allowAtlas);
+
 			data->initFromPath(path);
 
 			if (allowAsync && Settings::getInstance()->getBool("AsyncImages")) // && ImageIO::loadImageSize(ResourceManager::getInstance()->getResourcePath(path), &width, &height))
@@ -40,6 +42,7 @@ TextureResource::TextureResource(const std::string& path, bool tile, bool linear
 				mTextureData->setMaxSize(*maxSize);
 
 			mTextureData->setDynamic(false);
+			mTextureData->setAtlasAllowed(allowAtlas);
 			mTextureData->initFromPath(path);
 			mTextureData->load();			
 		}
@@ -81,7 +84,7 @@ void TextureResource::cleanupTextureResourceCache()
 		sTextureMap.erase(tmp);
 }
 
-std::shared_ptr<TextureResource> TextureResource::get(const std::string& path, bool tile, bool linear, bool forceLoad, bool dynamic, bool asReloadable, const MaxSizeInfo* maxSize, const std::string& shareId)
+std::shared_ptr<TextureResource> TextureResource::get(const std::string& path, bool tile, bool linear, bool forceLoad, bool dynamic, bool asReloadable, const MaxSizeInfo* maxSize, const std::string& shareId, bool allowAtlas)
 {
 	std::shared_ptr<ResourceManager>& rm = ResourceManager::getInstance();
 
@@ -97,7 +100,10 @@ std::shared_ptr<TextureResource> TextureResource::get(const std::string& path, b
 	if (canonicalPath.length() > 0 && canonicalPath[0] == ':')
 		dynamic = false;
 
-	TextureKeyType key(canonicalPath, tile, linear, shareId);
+	// Atlas textures need remapped texture coordinates : never share them with other consumers
+	allowAtlas = allowAtlas && !tile;
+
+	TextureKeyType key(canonicalPath, tile, linear, shareId, allowAtlas);
 
 	//TextureKeyType key(canonicalPath, tile, linear);
 	auto foundTexture = sTextureMap.find(key);
@@ -136,7 +142,7 @@ std::shared_ptr<TextureResource> TextureResource::get(const std::string& path, b
 
 	// need to create it
 	std::shared_ptr<TextureResource> tex;
-	tex = std::make_shared<TextureResource>(std::get<0>(key), tile, linear, dynamic, !forceLoad, maxSize);
+	tex = std::make_shared<TextureResource>(std::get<0>(key), tile, linear, dynamic, !forceLoad, maxSize, allowAtlas);
 
 	auto loadMode = forceLoad ? TextureLoadMode::STANDARD: TextureLoadMode::NOLOAD;
 	std::shared_ptr<TextureData> data = sTextureDataManager.get(tex.get(), loadMode);
@@ -342,6 +348,12 @@ const Vector2f TextureResource::getPhysicalSize() const
 	return data && data->isLoaded() ? data->getPhysicalSize() : Vector2f::Zero(); // mPhysicalSize;
 }
 
+const Vector4f TextureResource::getTextureRect() const
+{
+	auto data = mTextureData ? mTextureData : sTextureDataManager.get(this, TextureLoadMode::NOLOAD);
+	return data ? data->getTextureRect() : Vector4f(0.0f, 0.0f, 1.0f, 1.0f);
+}
+
 void TextureResource::cleanupVRAM()
 {
 	sTextureDataManager.cleanupVRAM();
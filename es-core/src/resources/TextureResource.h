@@ -4,6 +4,7 @@
 
 #include "math/Vector2i.h"
 #include "math/Vector2f.h"
+#include "math/Vector4f.h"
 #include "resources/ResourceManager.h"
 #include "resources/TextureDataManager.h"
 #include "resources/TextureData.h"
@@ -16,12 +17,12 @@
 class TextureResource : public IReloadable
 {
 public:
-	TextureResource(const std::string& path, bool tile, bool linear, bool dynamic, bool allowAsync, const MaxSizeInfo* maxSize = nullptr);
+	TextureResource(const std::string& path, bool tile, bool linear, bool dynamic, bool allowAsync, const MaxSizeInfo* maxSize = nullptr, bool allowAtlas = false);
 
 public:
 	static void cancelAsync(std::shared_ptr<TextureResource> texture);
 
-	static std::shared_ptr<TextureResource> get(const std::string& path, bool tile = false, bool linear = false, bool forceLoad = false, bool dynamic = true, bool asReloadable = true, const MaxSizeInfo* maxSize = nullptr, const std::string& shareId = "");
+	static std::shared_ptr<TextureResource> get(const std::string& path, bool tile = false, bool linear = false, bool forceLoad = false, bool dynamic = true, bool asReloadable = true, const MaxSizeInfo* maxSize = nullptr, const std::string& shareId = "", bool allowAtlas = false);
 	static void cleanupTextureResourceCache();
 	
 	void initFromPixels(unsigned char* dataRGBA, size_t width, size_t height);
@@ -34,6 +35,9 @@ public:
 	const Vector2i getSize() const;
 	const Vector2f getPhysicalSize() const;
 
+	// Area of the bound texture used by this image, in normalized texture coordinates. (0, 0, 1, 1) unless packed in the atlas
+	const Vector4f getTextureRect() const;
+
 	virtual ~TextureResource();
 
 	bool isLoaded() const;
@@ -66,7 +70,7 @@ private:
 	static TextureDataManager		sTextureDataManager;
 	bool							mForceLoad;
 
-	typedef std::tuple<std::string, bool, bool, std::string> TextureKeyType;
+	typedef std::tuple<std::string, bool, bool, std::string, bool> TextureKeyType;
 	static std::map< TextureKeyType, std::weak_ptr<TextureResource> > sTextureMap; // map of textures, used to prevent duplicate textures
 	static std::set<TextureResource*> 	sNonDynamicTextureResources;
 };
@@ -0,0 +1,274 @@
+#include "resources/VideoProxyCache.h"
+
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+#include "Paths.h"
+#include "Log.h"
+#include <vlc/vlc.h>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+
+#define VIDEO_PROXY_SIZE_STEP	32
+#define VIDEO_PROXY_TIMEOUT		120000 // ms
+#define VIDEO_PROXY_MAX_SIZE	(256ULL * 1024 * 1024) // bytes
+
+std::mutex					VideoProxyCache::sLock;
+std::condition_variable		VideoProxyCache::sEvent;
+std::deque<VideoProxyCache::Job> VideoProxyCache::sQueue;
+std::set<std::string>		VideoProxyCache::sPending;
+std::set<std::string>		VideoProxyCache::sFailed;
+std::thread*				VideoProxyCache::sThread = nullptr;
+std::atomic<bool>			VideoProxyCache::sStopping(false);
+libvlc_instance_t*			VideoProxyCache::sVLC = nullptr;
+std::list<std::string>		VideoProxyCache::sLru;
+std::map<std::string, VideoProxyCache::Entry> VideoProxyCache::sEntries;
+unsigned long long			VideoProxyCache::sTotalSize = 0;
+bool						VideoProxyCache::sIndexLoaded = false;
+
+#if WIN32
+extern void _checkUpgradedVlcVersion();
+#endif
+
+static std::string getVideoProxyPath()
+{
+	return Utils::FileSystem::getGenericPath(Paths::getUserEmulationStationPath() + "/tmp/videoproxies");
+}
+
+std::string VideoProxyCache::getProxy(const std::string& videoPath, const Vector2i& boxSize)
+{
+	if (videoPath.empty() || boxSize.x() <= 0 || boxSize.y() <= 0)
+		return "";
+
+	// Round the box size up, so boxes of close sizes share the same proxy
+	Vector2i size(
+		((boxSize.x() + VIDEO_PROXY_SIZE_STEP - 1) / VIDEO_PROXY_SIZE_STEP) * VIDEO_PROXY_SIZE_STEP,
+		((boxSize.y() + VIDEO_PROXY_SIZE_STEP - 1) / VIDEO_PROXY_SIZE_STEP) * VIDEO_PROXY_SIZE_STEP);
+
+	// The source file stamp is part of the key : a re-scraped video gets a new proxy
+	std::string key = videoPath + "|" +
+		std::to_string(Utils::FileSystem::getFileSize(videoPath)) + "|" +
+		std::to_string((long long)Utils::FileSystem::getFileModificationDate(videoPath).getTime());
+
+	char hash[32];
+	snprintf(hash, sizeof(hash), "%016llx", (unsigned long long) std::hash<std::string>()(key));
+
+	std::string target = getVideoProxyPath() + "/" + hash + "_" + std::to_string(size.x()) + "x" + std::to_string(size.y()) + ".mp4";
+
+	std::unique_lock<std::mutex> lock(sLock);
+
+	if (Utils::FileSystem::exists(target))
+	{
+		loadIndex();
+		touch(target);
+		return target;
+	}
+
+	if (sStopping || sPending.find(target) != sPending.cend() || sFailed.find(target) != sFailed.cend())
+		return "";
+
+	Job job;
+	job.source = videoPath;
+	job.target = target;
+	job.size = size;
+
+	sPending.insert(target);
+	sQueue.push_back(job);
+
+	if (sThread == nullptr)
+		sThread = new std::thread(&VideoProxyCache::run);
+
+	sEvent.notify_one();
+	return "";
+}
+
+void VideoProxyCache::stop()
+{
+	{
+		std::unique_lock<std::mutex> lock(sLock);
+		if (sThread == nullptr)
+			return;
+
+		sStopping = true;
+		sQueue.clear();
+		sPending.clear();
+	}
+
+	sEvent.notify_all();
+	sThread->join();
+
+	std::unique_lock<std::mutex> lock(sLock);
+
+	delete sThread;
+	sThread = nullptr;
+
+	if (sVLC != nullptr)
+	{
+		libvlc_release(sVLC);
+		sVLC = nullptr;
+	}
+
+	sStopping = false;
+}
+
+void VideoProxyCache::run()
+{
+	while (true)
+	{
+		Job job;
+
+		{
+			std::unique_lock<std::mutex> lock(sLock);
+			sEvent.wait(lock, [] { return sStopping || !sQueue.empty(); });
+
+			if (sStopping)
+				break;
+
+			job = sQueue.front();
+			sQueue.pop_front();
+		}
+
+		bool done = transcode(job);
+
+		std::unique_lock<std::mutex> lock(sLock);
+		sPending.erase(job.target);
+
+		if (done)
+		{
+			loadIndex();
+			touch(job.target);
+			evict();
+		}
+		else if (!sStopping)
+		{
+			LOG(LogWarning) << "VideoProxyCache : unable to transcode " << job.source;
+			sFailed.insert(job.target);
+		}
+	}
+}
+
+void VideoProxyCache::loadIndex()
+{
+	if (sIndexLoaded)
+		return;
+
+	sIndexLoaded = true;
+
+	std::string path = getVideoProxyPath();
+	if (!Utils::FileSystem::exists(path))
+		return;
+
+	// Proxies from previous sessions are ordered by creation date
+	std::vector<std::pair<time_t, std::string>> files;
+	for (auto file : Utils::FileSystem::getDirContent(path))
+		if (Utils::FileSystem::getExtension(file) == ".mp4")
+			files.push_back(std::make_pair(Utils::FileSystem::getFileModificationDate(file).getTime(), file));
+
+	std::sort(files.begin(), files.end());
+
+	for (auto& file : files)
+		touch(file.second);
+
+	evict();
+}
+
+void VideoProxyCache::touch(const std::string& target)
+{
+	auto it = sEntries.find(target);
+	if (it != sEntries.cend())
+	{
+		sLru.splice(sLru.end(), sLru, it->second.lru);
+		return;
+	}
+
+	Entry entry;
+	entry.size = Utils::FileSystem::getFileSize(target);
+	entry.lru = sLru.insert(sLru.end(), target);
+
+	sEntries[target] = entry;
+	sTotalSize += entry.size;
+}
+
+void VideoProxyCache::evict()
+{
+	// Always keep the most recent one
+	while (sTotalSize > VIDEO_PROXY_MAX_SIZE && sLru.size() > 1)
+	{
+		std::string target = sLru.front();
+		sLru.pop_front();
+
+		auto it = sEntries.find(target);
+		if (it != sEntries.cend())
+		{
+			sTotalSize -= it->second.size;
+			sEntries.erase(it);
+		}
+
+		LOG(LogDebug) << "VideoProxyCache : removing " << target;
+		Utils::FileSystem::removeFile(target);
+	}
+}
+
+bool VideoProxyCache::transcode(const Job& job)
+{
+	if (sVLC == nullptr)
+	{
+		const char* args[] = { "--quiet", "--intf=dummy", "--vout=dummy", "--aout=dummy", "--no-video-title-show" };
+
+#if WIN32
+		_checkUpgradedVlcVersion();
+#endif
+
+		sVLC = libvlc_new(sizeof(args) / sizeof(args[0]), args);
+		if (sVLC == nullptr)
+			return false;
+	}
+
+	std::string path = getVideoProxyPath();
+	if (!Utils::FileSystem::exists(path))
+		Utils::FileSystem::createDirectory(path);
+
+	libvlc_media_t* media = libvlc_media_new_path(sVLC, Utils::FileSystem::getPreferredPath(job.source).c_str());
+	if (media == nullptr)
+		return false;
+
+	// Transcode to a temporary file, the proxy only appears when it is complete
+	std::string tmpFile = job.target + ".tmp";
+
+	std::string sout = ":sout=#transcode{vcodec=h264,venc=x264{preset=veryfast},maxwidth=" + std::to_string(job.size.x()) + ",maxheight=" + std::to_string(job.size.y()) +
+		",acodec=mp4a,ab=96,channels=2}:std{access=file,mux=mp4,dst=\"" + tmpFile + "\"}";
+
+	libvlc_media_add_option(media, sout.c_str());
+
+	libvlc_media_player_t* player = libvlc_media_player_new_from_media(media);
+	if (player == nullptr)
+	{
+		libvlc_media_release(media);
+		return false;
+	}
+
+	libvlc_media_player_play(player);
+
+	libvlc_state_t state = libvlc_NothingSpecial;
+	int elapsed = 0;
+
+	while (!sStopping && elapsed < VIDEO_PROXY_TIMEOUT)
+	{
+		state = libvlc_media_player_get_state(player);
+		if (state == libvlc_Ended || state == libvlc_Error)
+			break;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		elapsed += 50;
+	}
+
+	libvlc_media_player_stop(player);
+	libvlc_media_player_release(player);
+	libvlc_media_release(media);
+
+	if (!sStopping && state == libvlc_Ended && Utils::FileSystem::exists(tmpFile, false) && Utils::FileSystem::getFileSize(tmpFile) > 0)
+		return Utils::FileSystem::renameFile(tmpFile, job.target);
+
+	Utils::FileSystem::removeFile(tmpFile);
+	return false;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#ifndef ES_CORE_RESOURCES_VIDEO_PROXY_CACHE_H
+#define ES_CORE_RESOURCES_VIDEO_PROXY_CACHE_H
+
+#include "math/Vector2i.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+struct libvlc_instance_t;
+
+// Low resolution copies of video snaps, transcoded in the background to the size of the theme box displaying them,
+// so small video boxes don't need full size snaps to be decoded and scaled for each frame.
+// Proxies are stored in ~/.emulationstation/tmp/videoproxies, keyed by the source file stamp & the box size.
+// The least recently used proxies are deleted when the folder grows over VIDEO_PROXY_MAX_SIZE.
+class VideoProxyCache
+{
+public:
+	// Returns the proxy path if it already exists, else an empty string & the proxy is queued for transcoding
+	static std::string getProxy(const std::string& videoPath, const Vector2i& boxSize);
+
+	// Aborts the running transcoding & stops the worker (ex: when a game is launched). It restarts on the next request.
+	static void stop();
+
+private:
+	struct Job
+	{
+		std::string source;
+		std::string target;
+		Vector2i	size;
+	};
+
+	struct Entry
+	{
+		unsigned long long				size;
+		std::list<std::string>::iterator lru;
+	};
+
+	static void run();
+	static bool transcode(const Job& job);
+
+	// sLock must be locked
+	static void loadIndex();
+	static void touch(const std::string& target);
+	static void evict();
+
+	static std::mutex				sLock;
+	static std::condition_variable	sEvent;
+	static std::deque<Job>			sQueue;
+	static std::set<std::string>	sPending;
+	static std::set<std::string>	sFailed;
+	static std::thread*				sThread;
+	static std::atomic<bool>		sStopping;
+	static libvlc_instance_t*		sVLC;
+
+	static std::list<std::string>		sLru; // Least recently used first
+	static std::map<std::string, Entry>	sEntries;
+	static unsigned long long			sTotalSize;
+	static bool							sIndexLoaded;
+};
+
+#endif // ES_CORE_RESOURCES_VIDEO_PROXY_CACHE_H